@@ -375,6 +375,12 @@ Api::IoCallUint64Result VclIoHandle::recvmmsg(RawSliceArrays&, uint32_t, RecvMsg
   PANIC("not implemented");
 }
 
+Api::IoCallUint64Result VclIoHandle::sendmmsg(const RawSliceArrays&, int,
+                                              const Envoy::Network::Address::Ip*,
+                                              const Envoy::Network::Address::Instance&) {
+  PANIC("not implemented");
+}
+
 bool VclIoHandle::supportsMmsg() const { return false; }
 
 Api::SysCallIntResult VclIoHandle::bind(Envoy::Network::Address::InstanceConstSharedPtr address) {
@@ -102,6 +102,12 @@ public:
   virtual SysCallIntResult recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
                                     int flags, struct timespec* timeout) PURE;
 
+  /**
+   * @see sendmmsg (man 2 sendmmsg)
+   */
+  virtual SysCallIntResult sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
   /**
    * return true if the OS supports recvmmsg() and sendmmsg().
    */
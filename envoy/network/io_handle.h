@@ -120,6 +120,20 @@ public:
                                           int flags, const Address::Ip* self_ip,
                                           const Address::Instance& peer_address) PURE;
 
+  /**
+   * If the platform supports, send multiple messages to the same address in one call.
+   * @param slices are the messages to be sent, one entry of |slices| per message.
+   * @param flags flags to pass to the underlying sendmmsg function (see man 2 sendmmsg).
+   * @param self_ip is the same as the one in sendmsg(), and applies to all messages.
+   * @param peer_address is the destination address of all messages.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages sent for success, which may be fewer than
+   * the number of entries in |slices|.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, int flags,
+                                           const Address::Ip* self_ip,
+                                           const Address::Instance& peer_address) PURE;
+
   struct RecvMsgPerPacketInfo {
     // The destination address from transport header.
     Address::InstanceConstSharedPtr local_address_;
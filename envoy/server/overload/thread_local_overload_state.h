@@ -66,6 +66,13 @@ class ThreadLocalOverloadState : public ThreadLocal::ThreadLocalObject {
 public:
   // Get a thread-local reference to the value for the given action key.
   virtual const OverloadActionState& getState(const std::string& action) PURE;
+  /**
+   * Brings the values referenced by getState() up to date with the overload manager if it
+   * shares action states with worker threads. This picks up state changes which have not been
+   * delivered to this thread yet and is cheap enough to call on every new request. It is a no-op
+   * otherwise.
+   */
+  virtual void syncActionStates() PURE;
   /**
    * Invokes the corresponding resource monitor to allocate resource for given resource monitor in
    * a thread safe manner. Returns true if there is enough resource quota available and allocation
@@ -539,6 +539,8 @@ public:
   COUNTER(update_failure)                                                                          \
   COUNTER(update_no_rebuild)                                                                       \
   COUNTER(update_success)                                                                          \
+  COUNTER(upstream_cx_adaptive_preconnect)                                                         \
+  COUNTER(upstream_cx_adaptive_preconnect_trimmed)                                                 \
   COUNTER(upstream_cx_close_notify)                                                                \
   COUNTER(upstream_cx_connect_attempts_exceeded)                                                   \
   COUNTER(upstream_cx_connect_fail)                                                                \
@@ -763,6 +765,13 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the target queue wait of adaptive preconnecting, or absl::nullopt if adaptive
+   *         preconnecting is disabled.
+   */
+  virtual const absl::optional<std::chrono::milliseconds>
+  adaptivePreconnectTargetQueueWait() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
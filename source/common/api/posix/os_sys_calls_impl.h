@@ -25,6 +25,8 @@ public:
   SysCallSizeResult recvmsg(os_fd_t sockfd, msghdr* msg, int flags) override;
   SysCallIntResult recvmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                             struct timespec* timeout) override;
+  SysCallIntResult sendmmsg(os_fd_t sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                            int flags) override;
   bool supportsMmsg() const override;
   bool supportsUdpGro() const override;
   bool supportsUdpGso() const override;
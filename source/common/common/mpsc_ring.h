@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Bounded lock-free queue with any number of producer threads and a single consumer thread.
+ * Each slot carries a sequence number which tells producers whether it is free for the position
+ * they claimed and the consumer whether it has been published, so that neither side has to take
+ * a lock. push() fails rather than blocking when the ring is full.
+ */
+template <class T> class MpscRing : NonCopyable {
+public:
+  /**
+   * @param capacity supplies the number of slots, which must be a power of two.
+   */
+  explicit MpscRing(uint64_t capacity)
+      : mask_(capacity - 1), slots_(std::make_unique<Slot[]>(capacity)) {
+    RELEASE_ASSERT(capacity > 0 && (capacity & mask_) == 0, "capacity must be a power of two");
+    for (uint64_t i = 0; i < capacity; ++i) {
+      slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Adds an element to the ring. May be called from any thread.
+   * @param value supplies the element, which is only moved from if the push succeeds.
+   * @return true if the element was added, false if the ring is full.
+   */
+  bool push(T&& value) {
+    uint64_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position & mask_];
+      const uint64_t sequence = slot->sequence_.load(std::memory_order_acquire);
+      const int64_t difference = static_cast<int64_t>(sequence - position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                    std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // The consumer has not yet released the slot from the previous lap.
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value_ = std::move(value);
+    slot->sequence_.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes the oldest published element from the ring. Must only be called from the consumer
+   * thread.
+   * @param value supplies the element to move the removed element into.
+   * @return true if an element was removed, false if the ring is empty.
+   */
+  bool pop(T& value) {
+    Slot& slot = slots_[dequeue_position_ & mask_];
+    if (slot.sequence_.load(std::memory_order_acquire) != dequeue_position_ + 1) {
+      return false;
+    }
+    value = std::move(slot.value_);
+    slot.value_ = T();
+    slot.sequence_.store(dequeue_position_ + mask_ + 1, std::memory_order_release);
+    ++dequeue_position_;
+    return true;
+  }
+
+  uint64_t capacity() const { return mask_ + 1; }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> sequence_;
+    T value_;
+  };
+
+  const uint64_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  // Producers and the consumer update their positions independently, so keep them on separate
+  // cache lines.
+  alignas(64) std::atomic<uint64_t> enqueue_position_{0};
+  alignas(64) uint64_t dequeue_position_{0};
+};
+
+} // namespace Envoy
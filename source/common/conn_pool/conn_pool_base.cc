@@ -17,6 +17,16 @@ namespace {
   }
   return ret;
 }
+
+std::unique_ptr<PreconnectEstimator>
+createPreconnectEstimator(const Upstream::ClusterInfo& cluster) {
+  const absl::optional<std::chrono::milliseconds> target_queue_wait =
+      cluster.adaptivePreconnectTargetQueueWait();
+  if (!target_queue_wait.has_value()) {
+    return nullptr;
+  }
+  return std::make_unique<PreconnectEstimator>(target_queue_wait.value());
+}
 } // namespace
 
 ConnPoolImplBase::ConnPoolImplBase(
@@ -26,6 +36,9 @@ ConnPoolImplBase::ConnPoolImplBase(
     Upstream::ClusterConnectivityState& state)
     : state_(state), host_(host), priority_(priority), dispatcher_(dispatcher),
       socket_options_(options), transport_socket_options_(transport_socket_options),
+      attach_to_least_loaded_client_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.conn_pool_attach_to_least_loaded_client")),
+      preconnect_estimator_(createPreconnectEstimator(host_->cluster())),
       upstream_ready_cb_(dispatcher_.createSchedulableCallback([this]() { onUpstreamReady(); })) {}
 
 ConnPoolImplBase::~ConnPoolImplBase() {
@@ -102,6 +115,51 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
   }
 }
 
+bool ConnPoolImplBase::shouldAdaptivelyPreconnect() const {
+  // As with preconnecting for the preconnect ratio, don't make unhealthy hosts do extra work.
+  if (preconnect_estimator_ == nullptr || host_->health() != Upstream::Host::Health::Healthy) {
+    return false;
+  }
+  const uint64_t spare_capacity =
+      preconnect_estimator_->spareStreamCapacity(dispatcher_.timeSource().monotonicTime());
+  if (spare_capacity == 0) {
+    return false;
+  }
+  // Keep enough capacity for the pending streams plus the spare capacity. The active streams are
+  // already served.
+  return connecting_stream_capacity_ + readyStreamCapacity() <
+         pending_streams_.size() + spare_capacity;
+}
+
+bool ConnPoolImplBase::adaptivelyPreconnectedConnectionIsExcess(const ActiveClient& client) const {
+  ASSERT(client.state() == ActiveClient::State::Ready && client.numActiveStreams() == 0);
+  if (!pending_streams_.empty()) {
+    return false;
+  }
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  // The demand to stay provisioned for is the recent peak, or what the preconnect ratio asks for
+  // if that is more.
+  const double demand = std::max<double>(preconnect_estimator_->peakDemand(now),
+                                         num_active_streams_ * perUpstreamPreconnectRatio());
+  const uint64_t capacity_without_client = connecting_stream_capacity_ + readyStreamCapacity() +
+                                           num_active_streams_ - client.currentUnusedCapacity();
+  return capacity_without_client >= demand + preconnect_estimator_->spareStreamCapacity(now);
+}
+
+uint64_t ConnPoolImplBase::readyStreamCapacity() const {
+  uint64_t capacity = 0;
+  for (const auto& client : ready_clients_) {
+    capacity += std::max<int64_t>(client->currentUnusedCapacity(), 0);
+  }
+  return capacity;
+}
+
+void ConnPoolImplBase::recordDemand(uint64_t demand) {
+  if (preconnect_estimator_ != nullptr) {
+    preconnect_estimator_->onDemand(dispatcher_.timeSource().monotonicTime(), demand);
+  }
+}
+
 float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
@@ -127,9 +185,14 @@ ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
 ConnPoolImplBase::ConnectionResult
 ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   // There are already enough Connecting connections for the number of queued streams.
+  bool adaptive_preconnect = false;
   if (!shouldCreateNewConnection(global_preconnect_ratio)) {
-    ENVOY_LOG(trace, "not creating a new connection, shouldCreateNewConnection returned false.");
-    return ConnectionResult::ShouldNotConnect;
+    // Adaptive preconnecting is local to this pool, so it is not done for global preconnecting.
+    adaptive_preconnect = global_preconnect_ratio == 0 && shouldAdaptivelyPreconnect();
+    if (!adaptive_preconnect) {
+      ENVOY_LOG(trace, "not creating a new connection, shouldCreateNewConnection returned false.");
+      return ConnectionResult::ShouldNotConnect;
+    }
   }
 
   const bool can_create_connection = host_->canCreateConnection(priority_);
@@ -155,6 +218,9 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
     // Increase the connecting capacity to reflect the streams this connection can serve.
     incrConnectingAndConnectedStreamCapacity(client->currentUnusedCapacity(), *client);
     LinkedList::moveIntoList(std::move(client), owningList(client->state()));
+    if (adaptive_preconnect) {
+      host_->cluster().stats().upstream_cx_adaptive_preconnect_.inc();
+    }
     return can_create_connection ? ConnectionResult::CreatedNewConnection
                                  : ConnectionResult::CreatedButRateLimited;
   } else {
@@ -183,6 +249,10 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   // Latch capacity before updating remaining streams.
   uint64_t capacity = client.currentUnusedCapacity();
   client.remaining_streams_--;
+  client.attached_streams_++;
+  if (client.load_indexed_) {
+    ready_clients_by_load_.onLoadIncremented(client);
+  }
   if (client.remaining_streams_ == 0) {
     ENVOY_CONN_LOG(debug, "maximum streams per connection, start draining", client);
     host_->cluster().stats().upstream_cx_max_requests_.inc();
@@ -213,8 +283,14 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
                                       bool delay_attaching_stream) {
   ENVOY_CONN_LOG(debug, "destroying stream: {} remaining", client, client.numActiveStreams());
   ASSERT(num_active_streams_ > 0);
+  ASSERT(client.attached_streams_ > 0);
+  client.attached_streams_--;
+  if (client.load_indexed_) {
+    ready_clients_by_load_.onLoadDecremented(client);
+  }
   state_.decrActiveStreams(1);
   num_active_streams_--;
+  recordDemand(num_active_streams_ + pending_streams_.size());
   host_->stats().rq_active_.dec();
   host_->cluster().stats().upstream_rq_active_.dec();
   host_->cluster().resourceManager(priority_).requests().dec();
@@ -244,6 +320,14 @@ void ConnPoolImplBase::onStreamClosed(Envoy::ConnectionPool::ActiveClient& clien
       }
     } else {
       transitionActiveClientState(client, ActiveClient::State::Ready);
+      if (preconnect_estimator_ != nullptr && client.numActiveStreams() == 0 &&
+          adaptivelyPreconnectedConnectionIsExcess(client)) {
+        ENVOY_CONN_LOG(debug, "closing idle connection no longer needed for adaptive preconnect",
+                       client);
+        host_->cluster().stats().upstream_cx_adaptive_preconnect_trimmed_.inc();
+        client.close();
+        return;
+      }
       if (!delay_attaching_stream) {
         onUpstreamReady();
       }
@@ -259,8 +343,10 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
   ASSERT(static_cast<ssize_t>(connecting_stream_capacity_) ==
          connectingCapacity(connecting_clients_) +
              connectingCapacity(early_data_clients_)); // O(n) debug check.
+  // Count the new stream as demand whether or not it is served right away.
+  recordDemand(num_active_streams_ + pending_streams_.size() + 1);
   if (!ready_clients_.empty()) {
-    ActiveClient& client = *ready_clients_.front();
+    ActiveClient& client = nextReadyClient();
     ENVOY_CONN_LOG(debug, "using existing fully connected connection", client);
     attachStreamToClient(client, context);
     // Even if there's a ready client, we may want to preconnect to handle the next incoming stream.
@@ -323,10 +409,10 @@ void ConnPoolImplBase::scheduleOnUpstreamReady() {
 
 void ConnPoolImplBase::onUpstreamReady() {
   while (!pending_streams_.empty() && !ready_clients_.empty()) {
-    ActiveClientPtr& client = ready_clients_.front();
-    ENVOY_CONN_LOG(debug, "attaching to next stream", *client);
+    ActiveClient& client = nextReadyClient();
+    ENVOY_CONN_LOG(debug, "attaching to next stream", client);
     // Pending streams are pushed onto the front, so pull from the back.
-    attachStreamToClient(*client, pending_streams_.back()->context());
+    attachStreamToClient(client, pending_streams_.back()->context());
     state_.decrPendingStreams(1);
     pending_streams_.pop_back();
   }
@@ -335,6 +421,14 @@ void ConnPoolImplBase::onUpstreamReady() {
   }
 }
 
+ActiveClient& ConnPoolImplBase::nextReadyClient() {
+  ASSERT(!ready_clients_.empty());
+  if (attach_to_least_loaded_client_) {
+    return *ready_clients_by_load_.leastLoaded();
+  }
+  return *ready_clients_.front();
+}
+
 std::list<ActiveClientPtr>& ConnPoolImplBase::owningList(ActiveClient::State state) {
   switch (state) {
   case ActiveClient::State::Connecting:
@@ -356,7 +450,13 @@ void ConnPoolImplBase::transitionActiveClientState(ActiveClient& client,
                                                    ActiveClient::State new_state) {
   auto& old_list = owningList(client.state());
   auto& new_list = owningList(new_state);
+  if (client.load_indexed_ && new_state != ActiveClient::State::Ready) {
+    ready_clients_by_load_.remove(client);
+  }
   client.setState(new_state);
+  if (!client.load_indexed_ && new_state == ActiveClient::State::Ready) {
+    ready_clients_by_load_.add(client);
+  }
 
   // old_list and new_list can be equal when transitioning from Busy to Draining.
   //
@@ -376,9 +476,14 @@ void ConnPoolImplBase::closeIdleConnectionsForDrainingPool() {
   // Create a separate list of elements to close to avoid mutate-while-iterating problems.
   std::list<ActiveClient*> to_close;
 
-  for (auto& client : ready_clients_) {
-    if (client->numActiveStreams() == 0) {
-      to_close.push_back(client.get());
+  if (attach_to_least_loaded_client_) {
+    // The index holds the idle ready clients together, so the busy ones need not be visited.
+    to_close = ready_clients_by_load_.idleClients();
+  } else {
+    for (auto& client : ready_clients_) {
+      if (client->numActiveStreams() == 0) {
+        to_close.push_back(client.get());
+      }
     }
   }
 
@@ -535,6 +640,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
       client.connection_duration_timer_.reset();
     }
 
+    if (client.load_indexed_) {
+      ready_clients_by_load_.remove(client);
+    }
     dispatcher_.deferredDelete(client.removeFromList(owningList(client.state())));
 
     // Check if the pool transitioned to idle state after removing closed client
@@ -563,6 +671,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ASSERT(connecting_stream_capacity_ >= client.currentUnusedCapacity());
     connecting_stream_capacity_ -= client.currentUnusedCapacity();
     client.has_handshake_completed_ = true;
+    if (preconnect_estimator_ != nullptr) {
+      preconnect_estimator_->onConnectLatency(client.conn_connect_ms_->elapsed());
+    }
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
     if (client.state() == ActiveClient::State::Connecting ||
@@ -737,6 +848,71 @@ void ConnPoolImplBase::onUpstreamReadyForEarlyData(ActiveClient& client) {
   }
 }
 
+void ActiveClientLoadIndex::add(ActiveClient& client) {
+  ASSERT(!client.load_indexed_);
+  const uint32_t load = client.attached_streams_;
+  auto bucket = buckets_.begin();
+  if (bucket == buckets_.end() || load <= bucket->load_) {
+    if (bucket == buckets_.end() || load < bucket->load_) {
+      bucket = buckets_.insert(bucket, ActiveClientLoadBucket{load, {}});
+    }
+  } else {
+    // Clients usually become ready again as soon as their first stream closes, so the search for
+    // any other load starts at the most loaded bucket.
+    bucket = buckets_.end();
+    while (std::prev(bucket)->load_ > load) {
+      --bucket;
+    }
+    if (std::prev(bucket)->load_ == load) {
+      --bucket;
+    } else {
+      bucket = buckets_.insert(bucket, ActiveClientLoadBucket{load, {}});
+    }
+  }
+  client.load_bucket_ = bucket;
+  client.load_bucket_entry_ = bucket->clients_.insert(bucket->clients_.begin(), &client);
+  client.load_indexed_ = true;
+}
+
+void ActiveClientLoadIndex::remove(ActiveClient& client) {
+  ASSERT(client.load_indexed_);
+  client.load_bucket_->clients_.erase(client.load_bucket_entry_);
+  if (client.load_bucket_->clients_.empty()) {
+    buckets_.erase(client.load_bucket_);
+  }
+  client.load_indexed_ = false;
+}
+
+void ActiveClientLoadIndex::onLoadIncremented(ActiveClient& client) {
+  ASSERT(client.load_indexed_ && client.load_bucket_->load_ + 1 == client.attached_streams_);
+  auto next = std::next(client.load_bucket_);
+  if (next == buckets_.end() || next->load_ != client.attached_streams_) {
+    next = buckets_.insert(next, ActiveClientLoadBucket{client.attached_streams_, {}});
+  }
+  moveToBucket(client, next);
+}
+
+void ActiveClientLoadIndex::onLoadDecremented(ActiveClient& client) {
+  ASSERT(client.load_indexed_ && client.load_bucket_->load_ == client.attached_streams_ + 1);
+  auto prev = client.load_bucket_;
+  if (prev == buckets_.begin() || (--prev)->load_ != client.attached_streams_) {
+    prev = buckets_.insert(client.load_bucket_,
+                           ActiveClientLoadBucket{client.attached_streams_, {}});
+  }
+  moveToBucket(client, prev);
+}
+
+void ActiveClientLoadIndex::moveToBucket(ActiveClient& client,
+                                         std::list<ActiveClientLoadBucket>::iterator bucket) {
+  // Splicing keeps load_bucket_entry_ valid.
+  bucket->clients_.splice(bucket->clients_.begin(), client.load_bucket_->clients_,
+                          client.load_bucket_entry_);
+  if (client.load_bucket_->clients_.empty()) {
+    buckets_.erase(client.load_bucket_);
+  }
+  client.load_bucket_ = bucket;
+}
+
 namespace {
 // Translate zero to UINT64_MAX so that the zero/unlimited case doesn't
 // have to be handled specially.
@@ -9,6 +9,7 @@
 #include "source/common/common/debug_recursion_checker.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
+#include "source/common/conn_pool/preconnect_estimator.h"
 
 #include "absl/strings/string_view.h"
 
@@ -16,6 +17,13 @@ namespace Envoy {
 namespace ConnectionPool {
 
 class ConnPoolImplBase;
+class ActiveClient;
+
+// The clients of an ActiveClientLoadIndex with the same number of attached streams.
+struct ActiveClientLoadBucket {
+  uint32_t load_;
+  std::list<ActiveClient*> clients_;
+};
 
 // A placeholder struct for whatever data a given connection pool needs to
 // successfully attach an upstream connection to a downstream connection.
@@ -146,6 +154,12 @@ public:
   bool timed_out_{false};
   // TODO(danzh) remove this once http codec exposes the handshake state for h3.
   bool has_handshake_completed_{false};
+  // The number of streams the pool attached to this client which have not been closed yet.
+  uint32_t attached_streams_{0};
+  // The position of this client in its pool's ActiveClientLoadIndex, valid while load_indexed_.
+  bool load_indexed_{false};
+  std::list<ActiveClientLoadBucket>::iterator load_bucket_;
+  std::list<ActiveClient*>::iterator load_bucket_entry_;
 
 protected:
   // HTTP/3 subclass should override this.
@@ -178,6 +192,40 @@ using PendingStreamPtr = std::unique_ptr<PendingStream>;
 
 using ActiveClientPtr = std::unique_ptr<ActiveClient>;
 
+// Indexes clients by the number of streams attached to them, so that the least loaded client can
+// be found in constant time. Clients with equal load share a bucket, and buckets are kept in
+// increasing order of load. Attaching or closing a stream moves a client to the neighbouring
+// bucket, which is also constant time. Adding a client searches for its bucket from the nearer
+// end, which is immediate for new clients and clients that just left the Busy state.
+class ActiveClientLoadIndex {
+public:
+  ~ActiveClientLoadIndex() { ASSERT(buckets_.empty()); }
+
+  void add(ActiveClient& client);
+  void remove(ActiveClient& client);
+  // Called after the client's attached_streams_ was incremented or decremented.
+  void onLoadIncremented(ActiveClient& client);
+  void onLoadDecremented(ActiveClient& client);
+
+  // Returns the client with the fewest attached streams, or nullptr if the index is empty. Of
+  // equally loaded clients, the most recently added or moved one is returned.
+  ActiveClient* leastLoaded() const {
+    return buckets_.empty() ? nullptr : buckets_.front().clients_.front();
+  }
+  // Returns the clients with no attached streams.
+  const std::list<ActiveClient*>& idleClients() const {
+    return (buckets_.empty() || buckets_.front().load_ != 0) ? no_clients_
+                                                             : buckets_.front().clients_;
+  }
+  bool empty() const { return buckets_.empty(); }
+
+private:
+  void moveToBucket(ActiveClient& client, std::list<ActiveClientLoadBucket>::iterator bucket);
+
+  std::list<ActiveClientLoadBucket> buckets_;
+  const std::list<ActiveClient*> no_clients_;
+};
+
 // Base class that handles stream queueing logic shared between connection pool implementations.
 class ConnPoolImplBase : protected Logger::Loggable<Logger::Id::pool> {
 public:
@@ -373,6 +421,9 @@ protected:
   // All entries are in state Ready.
   std::list<ActiveClientPtr> ready_clients_;
 
+  // The clients in ready_clients_, indexed by the number of streams attached to them.
+  ActiveClientLoadIndex ready_clients_by_load_;
+
   // Clients that are not ready to handle additional streams due to being Busy or Draining.
   std::list<ActiveClientPtr> busy_clients_;
 
@@ -388,6 +439,23 @@ protected:
   uint32_t connecting_stream_capacity_{0};
 
 private:
+  // Returns the Ready client the next stream should be attached to.
+  ActiveClient& nextReadyClient();
+
+  // Records the number of active and pending streams for adaptive preconnecting.
+  void recordDemand(uint64_t demand);
+
+  // Returns true if adaptive preconnecting calls for more connections than the pending and
+  // active streams do.
+  bool shouldAdaptivelyPreconnect() const;
+
+  // Returns true if the given idle Ready client is not needed for the recent peak demand or the
+  // spare capacity adaptive preconnecting keeps.
+  bool adaptivelyPreconnectedConnectionIsExcess(const ActiveClient& client) const;
+
+  // Returns the number of streams the Ready clients can still serve.
+  uint64_t readyStreamCapacity() const;
+
   // Drain all the clients in the given list.
   // Prerequisite: the given clients shouldn't be idle.
   void drainClients(std::list<ActiveClientPtr>& clients);
@@ -401,6 +469,13 @@ private:
   // all connections so that it can be gracefully deleted.
   bool is_draining_for_deletion_{false};
 
+  // If true, streams are attached to the least loaded Ready client rather than the most recently
+  // ready one, spreading them across the connections of a multiplexed pool.
+  const bool attach_to_least_loaded_client_;
+
+  // Set if the cluster enables adaptive preconnecting.
+  const std::unique_ptr<PreconnectEstimator> preconnect_estimator_;
+
   // True iff this object is in the deferred delete list.
   bool deferred_deleting_{false};
 
@@ -0,0 +1,89 @@
+#include "source/common/conn_pool/preconnect_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+double secondsBetween(MonotonicTime from, MonotonicTime to) {
+  return std::chrono::duration<double>(to - from).count();
+}
+
+double decay(double value, double elapsed_seconds, std::chrono::seconds time_constant) {
+  return value * std::exp(-std::max(elapsed_seconds, 0.0) / time_constant.count());
+}
+
+} // namespace
+
+PreconnectEstimator::PreconnectEstimator(std::chrono::milliseconds target_queue_wait)
+    : target_queue_wait_seconds_(std::chrono::duration<double>(target_queue_wait).count()) {}
+
+void PreconnectEstimator::onDemand(MonotonicTime now, uint64_t demand) {
+  if (last_sample_time_.has_value()) {
+    const double elapsed = secondsBetween(last_sample_time_.value(), now);
+    decayed_growth_ = decay(decayed_growth_, elapsed, GrowthWindow) +
+                      (static_cast<double>(demand) - static_cast<double>(last_demand_));
+    peak_demand_ = std::max<double>(
+        last_demand_ + decay(peak_demand_ - last_demand_, elapsed, PeakDecay), demand);
+  } else {
+    peak_demand_ = demand;
+  }
+  last_sample_time_ = now;
+  last_demand_ = demand;
+}
+
+void PreconnectEstimator::onConnectLatency(std::chrono::microseconds latency) {
+  const double sample = std::chrono::duration<double>(latency).count();
+  connect_latency_seconds_ =
+      connect_latency_seconds_.has_value()
+          ? connect_latency_seconds_.value() +
+                ConnectLatencyWeight * (sample - connect_latency_seconds_.value())
+          : sample;
+}
+
+double PreconnectEstimator::decayedGrowth(MonotonicTime now) const {
+  if (!last_sample_time_.has_value()) {
+    return 0;
+  }
+  return decay(decayed_growth_, secondsBetween(last_sample_time_.value(), now), GrowthWindow);
+}
+
+double PreconnectEstimator::demandGrowthRate(MonotonicTime now) const {
+  // Each change contributes for about one time constant, so the decayed sum over the time
+  // constant is the rate.
+  return decayedGrowth(now) / std::chrono::duration<double>(GrowthWindow).count();
+}
+
+absl::optional<std::chrono::microseconds> PreconnectEstimator::connectLatency() const {
+  if (!connect_latency_seconds_.has_value()) {
+    return absl::nullopt;
+  }
+  return std::chrono::microseconds(
+      static_cast<int64_t>(std::round(connect_latency_seconds_.value() * 1000000)));
+}
+
+uint64_t PreconnectEstimator::spareStreamCapacity(MonotonicTime now) const {
+  if (!connect_latency_seconds_.has_value()) {
+    return 0;
+  }
+  const double uncovered_latency = connect_latency_seconds_.value() - target_queue_wait_seconds_;
+  const double growth_rate = demandGrowthRate(now);
+  if (uncovered_latency <= 0 || growth_rate <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(std::ceil(growth_rate * uncovered_latency));
+}
+
+uint64_t PreconnectEstimator::peakDemand(MonotonicTime now) const {
+  if (!last_sample_time_.has_value()) {
+    return 0;
+  }
+  const double elapsed = secondsBetween(last_sample_time_.value(), now);
+  return static_cast<uint64_t>(
+      std::ceil(last_demand_ + decay(peak_demand_ - last_demand_, elapsed, PeakDecay)));
+}
+
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+
+/**
+ * Estimates, for one upstream's connection pool on one worker, how many streams' worth of spare
+ * connection capacity to keep established ahead of demand, so that the expected time a new stream
+ * waits for a connection stays within a target.
+ *
+ * Demand is the number of active and pending streams, sampled as streams arrive and complete.
+ * Streams that find spare capacity never wait, so what matters is how fast demand grows: while a
+ * connection is being established, demand grows by the growth rate times the connection latency.
+ * Keeping that much spare capacity, less what may arrive within the target wait, means the streams
+ * of a ramp find a connection ready. Both the growth rate and the latency, which includes any TLS
+ * handshake, are exponentially weighted moving averages.
+ *
+ * Connections beyond the recent peak demand plus the spare capacity are extras, and may be closed
+ * once idle. The peak decays towards the current demand, so extras are trimmed once a burst has
+ * passed, but not during the ordinary ups and downs of steady traffic.
+ */
+class PreconnectEstimator {
+public:
+  explicit PreconnectEstimator(std::chrono::milliseconds target_queue_wait);
+
+  /**
+   * Records the demand after a stream arrived or completed.
+   * @param now the current time.
+   * @param demand the number of active and pending streams.
+   */
+  void onDemand(MonotonicTime now, uint64_t demand);
+
+  /**
+   * Records how long a connection took to establish.
+   */
+  void onConnectLatency(std::chrono::microseconds latency);
+
+  /**
+   * @return the estimated rate at which demand grows, in streams per second. This is negative
+   *         while demand shrinks.
+   */
+  double demandGrowthRate(MonotonicTime now) const;
+
+  /**
+   * @return the estimated connection latency, or absl::nullopt if no connection was established
+   *         yet.
+   */
+  absl::optional<std::chrono::microseconds> connectLatency() const;
+
+  /**
+   * @return the number of streams' worth of connection capacity to keep available beyond the
+   *         current demand.
+   */
+  uint64_t spareStreamCapacity(MonotonicTime now) const;
+
+  /**
+   * @return the recent peak demand, decayed towards the current demand.
+   */
+  uint64_t peakDemand(MonotonicTime now) const;
+
+  // The time constant of the demand growth rate average.
+  static constexpr std::chrono::seconds GrowthWindow{1};
+  // The time constant with which the peak demand decays.
+  static constexpr std::chrono::seconds PeakDecay{10};
+  // The weight of each new connection latency sample.
+  static constexpr double ConnectLatencyWeight = 0.2;
+
+private:
+  double decayedGrowth(MonotonicTime now) const;
+
+  const double target_queue_wait_seconds_;
+  absl::optional<MonotonicTime> last_sample_time_;
+  uint64_t last_demand_{0};
+  // The sum of demand changes, each decayed by the time since it happened.
+  double decayed_growth_{0};
+  // The peak demand as of last_sample_time_.
+  double peak_demand_{0};
+  absl::optional<double> connect_latency_seconds_;
+};
+
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -691,10 +691,33 @@ ssize_t ConnectionImpl::StreamImpl::onDataSourceRead(uint64_t length, uint32_t*
       }
     }
 
-    return std::min(length, pending_send_data_->length());
+    return dataFrameLength(length);
   }
 }
 
+uint64_t ConnectionImpl::StreamImpl::dataFrameLength(uint64_t max_length) const {
+  if (pending_send_data_->length() <= max_length) {
+    return pending_send_data_->length();
+  }
+  if (!parent_.align_data_frames_to_slices_) {
+    return max_length;
+  }
+
+  // onDataSourceSend() moves whole slices into the output buffer, but has to copy the part of a
+  // slice that a frame ends in. If a frame of at least half the allowed size can end on a slice
+  // boundary, send that instead, so the payload is moved without being copied. The remainder of
+  // the slice then starts the next frame.
+  constexpr uint64_t MaxSlicesToScan = 16;
+  uint64_t aligned_length = 0;
+  for (const Buffer::RawSlice& slice : pending_send_data_->getRawSlices(MaxSlicesToScan)) {
+    if (aligned_length + slice.len_ > max_length) {
+      break;
+    }
+    aligned_length += slice.len_;
+  }
+  return aligned_length >= max_length / 2 ? aligned_length : max_length;
+}
+
 void ConnectionImpl::StreamImpl::onDataSourceSend(const uint8_t* framehd, size_t length) {
   // In this callback we are writing out a raw DATA frame without copying. nghttp2 assumes that we
   // "just know" that the frame header is 9 bytes.
@@ -945,6 +968,8 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       dispatching_(false), raised_goaway_(false),
       delay_keepalive_timeout_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.http2_delay_keepalive_timeout")),
+      align_data_frames_to_slices_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http2_align_data_frames_to_slices")),
       random_(random_generator),
       last_received_data_time_(connection_.dispatcher().timeSource().monotonicTime()) {
   // This library can only be used with the wrapper API enabled.
@@ -234,6 +234,7 @@ protected:
 
     StreamImpl* base() { return this; }
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
+    uint64_t dataFrameLength(uint64_t max_length) const;
     void onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
     static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
@@ -710,6 +711,9 @@ private:
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   const bool delay_keepalive_timeout_ : 1;
+  // Whether DATA frames may be shortened to end on a pending_send_data_ slice boundary. Guarded by
+  // the "envoy.reloadable_features.http2_align_data_frames_to_slices" runtime feature flag.
+  const bool align_data_frames_to_slices_ : 1;
   Event::SchedulableCallbackPtr protocol_constraint_violation_callback_;
   Random::RandomGenerator& random_;
   MonotonicTime last_received_data_time_{};
@@ -72,6 +72,9 @@ void HttpConnPoolImplMixed::onConnected(Envoy::ConnectionPool::ActiveClient& cli
   data.connection_->readDisable(false);
   data.connection_->removeConnectionCallbacks(*tcp_client);
   data.connection_->removeReadFilter(tcp_client->read_filter_handle_);
+  if (client.load_indexed_) {
+    ready_clients_by_load_.remove(client);
+  }
   dispatcher_.deferredDelete(client.removeFromList(owningList(client.state())));
 
   std::unique_ptr<ActiveClient> new_client;
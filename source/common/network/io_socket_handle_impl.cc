@@ -59,6 +59,46 @@ constexpr int messageTruncatedOption() {
 #endif
 }
 
+// Returns the control message space needed to select self_ip as the source address.
+size_t selfIpControlMessageSpace(const Network::Address::Ip& self_ip) {
+  // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
+  return self_ip.version() == Network::Address::IpVersion::v4 ? CMSG_SPACE(sizeof(in_pktinfo))
+                                                              : CMSG_SPACE(sizeof(in6_pktinfo));
+}
+
+// Fills in the control message of message, whose msg_control and msg_controllen must refer to
+// selfIpControlMessageSpace(self_ip) zeroed bytes, to select self_ip as the source address.
+void setSelfIpControlMessage(const Network::Address::Ip& self_ip, msghdr& message) {
+  cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
+  RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
+                                              message.msg_controllen, sizeof(cmsghdr)));
+  if (self_ip.version() == Network::Address::IpVersion::v4) {
+    cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_type = IP_PKTINFO;
+    auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_ifindex = 0;
+#ifdef WIN32
+    pktinfo->ipi_addr.s_addr = self_ip.ipv4()->address();
+#else
+    pktinfo->ipi_spec_dst.s_addr = self_ip.ipv4()->address();
+#endif
+#else
+    cmsg->cmsg_type = IP_SENDSRCADDR;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+    *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip.ipv4()->address();
+#endif
+  } else if (self_ip.version() == Network::Address::IpVersion::v6) {
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi6_ifindex = 0;
+    *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip.ipv6()->address();
+  }
+}
+
 } // namespace
 
 namespace Network {
@@ -180,50 +220,73 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   } else {
-    const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
-    const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
-
-    // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
-    const size_t cmsg_space = (self_ip->version() == Address::IpVersion::v4) ? space_v4 : space_v6;
-    // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
+    const size_t cmsg_space = selfIpControlMessageSpace(*self_ip);
     absl::FixedArray<char> cbuf(cmsg_space);
     memset(cbuf.begin(), 0, cmsg_space);
 
     message.msg_control = cbuf.begin();
     message.msg_controllen = cmsg_space;
-    cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
-    RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
-                                                sizeof(cbuf), sizeof(cmsghdr)));
-    if (self_ip->version() == Address::IpVersion::v4) {
-      cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_SENDSRCADDR
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-      cmsg->cmsg_type = IP_PKTINFO;
-      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi_ifindex = 0;
-#ifdef WIN32
-      pktinfo->ipi_addr.s_addr = self_ip->ipv4()->address();
-#else
-      pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
-#endif
-#else
-      cmsg->cmsg_type = IP_SENDSRCADDR;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-      *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
-#endif
-    } else if (self_ip->version() == Address::IpVersion::v6) {
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-      cmsg->cmsg_level = IPPROTO_IPV6;
-      cmsg->cmsg_type = IPV6_PKTINFO;
-      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi6_ifindex = 0;
-      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
-    }
+    setSelfIpControlMessage(*self_ip, message);
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   }
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const RawSliceArrays& slices, int flags,
+                                                     const Address::Ip* self_ip,
+                                                     const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  sockaddr* sock_addr = const_cast<sockaddr*>(address_base->sockAddr());
+  if (sock_addr == nullptr) {
+    // Unlikely to happen unless the wrong peer address is passed.
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+  if (slices.empty()) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  // All messages go to the same peer from the same source, so they share one control message.
+  const size_t cmsg_space = self_ip != nullptr ? selfIpControlMessageSpace(*self_ip) : 0;
+  absl::FixedArray<char> cbuf(cmsg_space);
+  if (cmsg_space > 0) {
+    memset(cbuf.begin(), 0, cmsg_space);
+  }
+
+  size_t num_iovs = 0;
+  for (const auto& message_slices : slices) {
+    num_iovs += message_slices.size();
+  }
+  absl::FixedArray<iovec> iovs(num_iovs);
+  absl::FixedArray<mmsghdr> mmsg_hdr(slices.size());
+  size_t next_iov = 0;
+  for (size_t i = 0; i < slices.size(); ++i) {
+    msghdr& message = mmsg_hdr[i].msg_hdr;
+    message.msg_name = reinterpret_cast<void*>(sock_addr);
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = iovs.begin() + next_iov;
+    message.msg_iovlen = 0;
+    message.msg_flags = 0;
+    for (const Buffer::RawSlice& slice : slices[i]) {
+      if (slice.mem_ != nullptr && slice.len_ != 0) {
+        iovs[next_iov].iov_base = slice.mem_;
+        iovs[next_iov].iov_len = slice.len_;
+        ++next_iov;
+        ++message.msg_iovlen;
+      }
+    }
+    message.msg_control = cmsg_space > 0 ? cbuf.begin() : nullptr;
+    message.msg_controllen = cmsg_space;
+    mmsg_hdr[i].msg_len = 0;
+  }
+  if (self_ip != nullptr) {
+    setSelfIpControlMessage(*self_ip, mmsg_hdr[0].msg_hdr);
+  }
+
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().sendmmsg(fd_, mmsg_hdr.data(), mmsg_hdr.size(), flags);
+  return sysCallResultToIoCallResult(result);
+}
+
 Address::InstanceConstSharedPtr maybeGetDstAddressFromHeader(const cmsghdr& cmsg,
                                                              uint32_t self_port, os_fd_t fd) {
   if (cmsg.cmsg_type == IPV6_PKTINFO) {
@@ -44,6 +44,10 @@ public:
                                   const Address::Ip* self_ip,
                                   const Address::Instance& peer_address) override;
 
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, int flags,
+                                   const Address::Ip* self_ip,
+                                   const Address::Instance& peer_address) override;
+
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
 
@@ -1,6 +1,7 @@
 #include "source/common/network/udp_packet_writer_handler_impl.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/logger.h"
 #include "source/common/network/utility.h"
 
 namespace Envoy {
@@ -24,5 +25,112 @@ Api::IoCallUint64Result UdpDefaultWriter::writePacket(const Buffer::Instance& bu
   return result;
 }
 
+UdpMmsgBatchWriter::UdpMmsgBatchWriter(Network::IoHandle& io_handle, uint32_t max_batch_size)
+    : io_handle_(io_handle), max_batch_size_(max_batch_size) {
+  ASSERT(max_batch_size_ > 0);
+  packet_ends_.reserve(max_batch_size_);
+}
+
+Api::IoCallUint64Result UdpMmsgBatchWriter::writePacket(const Buffer::Instance& buffer,
+                                                        const Address::Ip* local_ip,
+                                                        const Address::Instance& peer_address) {
+  ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
+  if (peer_address_ == nullptr || !isCurrentDestination(local_ip, peer_address)) {
+    if (!packet_ends_.empty()) {
+      Api::IoCallUint64Result result = flush();
+      if (write_blocked_) {
+        return result;
+      }
+    }
+    peer_address_ = Utility::copyInternetAddressAndPort(*peer_address.ip());
+    local_address_ =
+        local_ip != nullptr ? Utility::copyInternetAddressAndPort(*local_ip) : nullptr;
+  }
+
+  const uint64_t length = buffer.length();
+  for (const Buffer::RawSlice& slice : buffer.getRawSlices()) {
+    packets_.append(static_cast<const char*>(slice.mem_), slice.len_);
+  }
+  packet_ends_.push_back(packets_.size());
+  if (packet_ends_.size() >= max_batch_size_) {
+    Api::IoCallUint64Result result = flush();
+    if (!result.ok()) {
+      return result;
+    }
+  }
+  Api::IoCallUint64Result result = Api::ioCallUint64ResultNoError();
+  result.return_value_ = length;
+  return result;
+}
+
+bool UdpMmsgBatchWriter::isCurrentDestination(const Address::Ip* local_ip,
+                                              const Address::Instance& peer_address) const {
+  if (*peer_address_ != peer_address) {
+    return false;
+  }
+  if (local_ip == nullptr || local_address_ == nullptr) {
+    return local_ip == nullptr && local_address_ == nullptr;
+  }
+  return local_address_->ip()->addressAsString() == local_ip->addressAsString();
+}
+
+Api::IoCallUint64Result UdpMmsgBatchWriter::flush() {
+  uint64_t bytes_sent = 0;
+  size_t packets_sent = 0;
+  Api::IoCallUint64Result result = Api::ioCallUint64ResultNoError();
+  while (packets_sent < packet_ends_.size()) {
+    result = sendQueuedPackets(packets_sent);
+    if (!result.ok()) {
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Interrupt) {
+        continue;
+      }
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        // Writer is blocked when error code received is EWOULDBLOCK/EAGAIN
+        write_blocked_ = true;
+      }
+      ENVOY_LOG_MISC(debug, "dropping {} UDP packets after send failed with error code {}: {}",
+                     packet_ends_.size() - packets_sent,
+                     static_cast<int>(result.err_->getErrorCode()),
+                     result.err_->getErrorDetails());
+      break;
+    }
+    if (result.return_value_ == 0) {
+      // Not expected from a non-empty batch, but don't spin on it.
+      break;
+    }
+    const size_t end = packets_sent + result.return_value_;
+    bytes_sent += packet_ends_[end - 1] - packetBegin(packets_sent);
+    packets_sent = end;
+  }
+  packets_.clear();
+  packet_ends_.clear();
+  if (!result.ok()) {
+    return result;
+  }
+  result.return_value_ = bytes_sent;
+  return result;
+}
+
+Api::IoCallUint64Result UdpMmsgBatchWriter::sendQueuedPackets(size_t first_packet) {
+  const Address::Ip* local_ip = local_address_ != nullptr ? local_address_->ip() : nullptr;
+  if (!io_handle_.supportsMmsg()) {
+    Buffer::RawSlice slice{packets_.data() + packetBegin(first_packet),
+                           packet_ends_[first_packet] - packetBegin(first_packet)};
+    Api::IoCallUint64Result result = io_handle_.sendmsg(&slice, 1, 0, local_ip, *peer_address_);
+    if (result.ok()) {
+      result.return_value_ = 1;
+    }
+    return result;
+  }
+
+  RawSliceArrays slices(packet_ends_.size() - first_packet,
+                        absl::FixedArray<Buffer::RawSlice>(1));
+  for (size_t packet = first_packet; packet < packet_ends_.size(); ++packet) {
+    slices[packet - first_packet][0] = {packets_.data() + packetBegin(packet),
+                                        packet_ends_[packet] - packetBegin(packet)};
+  }
+  return io_handle_.sendmmsg(slices, 0, local_ip, *peer_address_);
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/network/socket.h"
 #include "envoy/network/udp_packet_writer_handler.h"
@@ -49,5 +52,72 @@ public:
   }
 };
 
+/**
+ * A batch mode writer which queues the packets written to one destination and sends them with a
+ * single sendmmsg() call when flushed, or with one sendmsg() call per packet where the platform
+ * doesn't support sendmmsg(). Writing a packet to another destination, or filling the queue,
+ * flushes the queued packets. As with UdpDefaultWriter, packets which can't be sent because the
+ * socket would block are dropped.
+ */
+class UdpMmsgBatchWriter : public UdpPacketWriter {
+public:
+  static constexpr uint32_t DefaultMaxBatchSize = 64;
+
+  UdpMmsgBatchWriter(Network::IoHandle& io_handle, uint32_t max_batch_size = DefaultMaxBatchSize);
+
+  // Queues a copy of the packet. The result is the packet's size on success.
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Address::Ip* local_ip,
+                                      const Address::Instance& peer_address) override;
+
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Address::Instance& /*peer_address*/) const override {
+    return Network::UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return true; }
+  Network::UdpPacketWriterBuffer
+  getNextWriteLocation(const Address::Ip* /*local_ip*/,
+                       const Address::Instance& /*peer_address*/) override {
+    return {nullptr, 0, nullptr};
+  }
+  // Sends the queued packets. The result is the number of bytes sent on success.
+  Api::IoCallUint64Result flush() override;
+
+  uint32_t queuedPackets() const { return packet_ends_.size(); }
+
+private:
+  bool isCurrentDestination(const Address::Ip* local_ip,
+                            const Address::Instance& peer_address) const;
+  // Sends queued packets starting at the given one, and returns the number of packets sent.
+  Api::IoCallUint64Result sendQueuedPackets(size_t first_packet);
+  size_t packetBegin(size_t packet) const { return packet == 0 ? 0 : packet_ends_[packet - 1]; }
+
+  Network::IoHandle& io_handle_;
+  const uint32_t max_batch_size_;
+  bool write_blocked_{false};
+  // The queued packets back to back, and the offset at which each of them ends.
+  std::string packets_;
+  std::vector<size_t> packet_ends_;
+  // The destination of the queued packets, kept across flushes to avoid copying the addresses of
+  // every batch.
+  Address::InstanceConstSharedPtr peer_address_;
+  Address::InstanceConstSharedPtr local_address_;
+};
+
+class UdpMmsgBatchWriterFactory : public Network::UdpPacketWriterFactory {
+public:
+  explicit UdpMmsgBatchWriterFactory(
+      uint32_t max_batch_size = UdpMmsgBatchWriter::DefaultMaxBatchSize)
+      : max_batch_size_(max_batch_size) {}
+
+  Network::UdpPacketWriterPtr createUdpPacketWriter(Network::IoHandle& io_handle,
+                                                    Stats::Scope&) override {
+    return std::make_unique<UdpMmsgBatchWriter>(io_handle, max_batch_size_);
+  }
+
+private:
+  const uint32_t max_batch_size_;
+};
+
 } // namespace Network
 } // namespace Envoy
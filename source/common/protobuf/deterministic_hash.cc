@@ -0,0 +1,157 @@
+#include "source/common/protobuf/deterministic_hash.h"
+
+#include <string>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+namespace {
+
+constexpr absl::string_view AnyFullName = "google.protobuf.Any";
+
+template <typename T> uint64_t hashScalar(T value, uint64_t seed) {
+  return HashUtil::xxHash64(
+      absl::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), seed);
+}
+
+uint64_t hashMessage(const Protobuf::Message& message, uint64_t seed);
+
+uint64_t hashAny(const Protobuf::Message& any, uint64_t seed) {
+  const Protobuf::Descriptor* descriptor = any.GetDescriptor();
+  const Protobuf::Reflection* reflection = any.GetReflection();
+  std::string type_url_scratch;
+  const std::string& type_url =
+      reflection->GetStringReference(any, descriptor->FindFieldByNumber(1), &type_url_scratch);
+  std::string value_scratch;
+  const std::string& value =
+      reflection->GetStringReference(any, descriptor->FindFieldByNumber(2), &value_scratch);
+  seed = HashUtil::xxHash64(type_url, seed);
+
+  // Hash the packed message rather than its bytes, since its serialization is not deterministic,
+  // e.g. for maps. A type that is not linked in is hashed by its bytes, as TextFormat prints it.
+  const size_t name_start = type_url.rfind('/');
+  const Protobuf::Descriptor* inner_descriptor =
+      descriptor->file()->pool()->FindMessageTypeByName(
+          name_start == std::string::npos ? type_url : type_url.substr(name_start + 1));
+  if (inner_descriptor != nullptr) {
+    const Protobuf::Message* prototype =
+        reflection->GetMessageFactory()->GetPrototype(inner_descriptor);
+    if (prototype != nullptr) {
+      ProtobufTypes::MessagePtr inner(prototype->New());
+      if (inner->ParseFromString(value)) {
+        return hashMessage(*inner, seed);
+      }
+    }
+  }
+  return HashUtil::xxHash64(value, seed);
+}
+
+uint64_t hashValue(const Protobuf::Message& message, const Protobuf::FieldDescriptor* field,
+                   uint64_t seed) {
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  switch (field->cpp_type()) {
+  case Protobuf::FieldDescriptor::CPPTYPE_INT32:
+    return hashScalar(reflection->GetInt32(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_INT64:
+    return hashScalar(reflection->GetInt64(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT32:
+    return hashScalar(reflection->GetUInt32(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT64:
+    return hashScalar(reflection->GetUInt64(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+    return hashScalar(reflection->GetDouble(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+    return hashScalar(reflection->GetFloat(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_BOOL:
+    return hashScalar(reflection->GetBool(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_ENUM:
+    return hashScalar(reflection->GetEnumValue(message, field), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_STRING: {
+    std::string scratch;
+    return HashUtil::xxHash64(reflection->GetStringReference(message, field, &scratch), seed);
+  }
+  case Protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+    return hashMessage(reflection->GetMessage(message, field), seed);
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+uint64_t hashRepeatedValue(const Protobuf::Message& message,
+                           const Protobuf::FieldDescriptor* field, int index, uint64_t seed) {
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  switch (field->cpp_type()) {
+  case Protobuf::FieldDescriptor::CPPTYPE_INT32:
+    return hashScalar(reflection->GetRepeatedInt32(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_INT64:
+    return hashScalar(reflection->GetRepeatedInt64(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT32:
+    return hashScalar(reflection->GetRepeatedUInt32(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_UINT64:
+    return hashScalar(reflection->GetRepeatedUInt64(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+    return hashScalar(reflection->GetRepeatedDouble(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+    return hashScalar(reflection->GetRepeatedFloat(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_BOOL:
+    return hashScalar(reflection->GetRepeatedBool(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_ENUM:
+    return hashScalar(reflection->GetRepeatedEnumValue(message, field, index), seed);
+  case Protobuf::FieldDescriptor::CPPTYPE_STRING: {
+    std::string scratch;
+    return HashUtil::xxHash64(
+        reflection->GetRepeatedStringReference(message, field, index, &scratch), seed);
+  }
+  case Protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+    return hashMessage(reflection->GetRepeatedMessage(message, field, index), seed);
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+uint64_t hashMessage(const Protobuf::Message& message, uint64_t seed) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  if (descriptor->full_name() == AnyFullName) {
+    return hashAny(message, seed);
+  }
+
+  // Walk the descriptor rather than Reflection::ListFields(), which would allocate a vector per
+  // message. HasField() and FieldSize() select the same fields as ListFields().
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated()) {
+      const int size = reflection->FieldSize(message, field);
+      if (size == 0) {
+        continue;
+      }
+      seed = hashScalar(field->number(), seed);
+      seed = hashScalar(size, seed);
+      if (field->is_map()) {
+        // Map entries have no defined order, so their hashes are combined commutatively.
+        uint64_t entries_hash = 0;
+        for (int index = 0; index < size; ++index) {
+          entries_hash += hashRepeatedValue(message, field, index, 0);
+        }
+        seed = hashScalar(entries_hash, seed);
+      } else {
+        for (int index = 0; index < size; ++index) {
+          seed = hashRepeatedValue(message, field, index, seed);
+        }
+      }
+    } else if (reflection->HasField(message, field)) {
+      seed = hashScalar(field->number(), seed);
+      seed = hashValue(message, field, seed);
+    }
+  }
+  return seed;
+}
+
+} // namespace
+
+uint64_t hash(const Protobuf::Message& message, uint64_t seed) {
+  return hashMessage(message, seed);
+}
+
+} // namespace DeterministicProtoHash
+} // namespace Envoy
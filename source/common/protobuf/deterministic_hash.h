@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+#include "source/common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+
+/**
+ * Hashes a message by walking its fields with reflection, rather than by hashing a serialized
+ * form. The result depends only on the message's contents: map entries are hashed independently
+ * of their order, google.protobuf.Any is hashed by its unpacked contents when its type is known,
+ * and unknown fields are ignored. Messages that print identically with TextFormat hash equally.
+ *
+ * Apart from unpacking Any, hashing does not allocate. The hash is stable within a build, but
+ * not across changes to the message definitions, so it must not be persisted.
+ *
+ * @param message the message to hash.
+ * @param seed the seed to hash with, allowing hashes to be chained.
+ * @return the hash.
+ */
+uint64_t hash(const Protobuf::Message& message, uint64_t seed = 0);
+
+} // namespace DeterministicProtoHash
+} // namespace Envoy
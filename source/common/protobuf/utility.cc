@@ -224,6 +224,10 @@ void ProtoExceptionUtil::throwProtoValidationException(const std::string& valida
 }
 
 size_t MessageUtil::hash(const Protobuf::Message& message) {
+  return DeterministicProtoHash::hash(message);
+}
+
+size_t MessageUtil::textFormatHash(const Protobuf::Message& message) {
   std::string text_format;
 
   {
@@ -11,6 +11,7 @@
 #include "source/common/common/hash.h"
 #include "source/common/common/stl_helpers.h"
 #include "source/common/common/utility.h"
+#include "source/common/protobuf/deterministic_hash.h"
 #include "source/common/protobuf/protobuf.h"
 #include "source/common/singleton/const_singleton.h"
 
@@ -167,20 +168,11 @@ public:
   // Based on MessageUtil::hash() defined below.
   template <class ProtoType>
   static std::size_t hash(const Protobuf::RepeatedPtrField<ProtoType>& source) {
-    std::string text;
-    {
-      Protobuf::TextFormat::Printer printer;
-      printer.SetExpandAny(true);
-      printer.SetUseFieldNumber(true);
-      printer.SetSingleLineMode(true);
-      printer.SetHideUnknownFields(true);
-      for (const auto& message : source) {
-        std::string text_message;
-        printer.PrintToString(message, &text_message);
-        absl::StrAppend(&text, text_message);
-      }
+    uint64_t hash = 0;
+    for (const auto& message : source) {
+      hash = DeterministicProtoHash::hash(message, hash);
     }
-    return HashUtil::xxHash64(text);
+    return hash;
   }
 
   /**
@@ -242,14 +234,21 @@ public:
   using FileExtensions = ConstSingleton<FileExtensionValues>;
 
   /**
-   * A hash function uses Protobuf::TextFormat to force deterministic serialization recursively
-   * including known types in google.protobuf.Any. See
-   * https://github.com/protocolbuffers/protobuf/issues/5731 for the context.
-   * Using this function is discouraged, see discussion in
+   * A deterministic hash of a message's contents, including known types in google.protobuf.Any
+   * and regardless of map order. See https://github.com/protocolbuffers/protobuf/issues/5731 for
+   * why the serialized form cannot be hashed instead. The message is walked with reflection, see
+   * DeterministicProtoHash::hash(). Using this function is discouraged, see discussion in
    * https://github.com/envoyproxy/envoy/issues/8301.
    */
   static std::size_t hash(const Protobuf::Message& message);
 
+  /**
+   * A hash function uses Protobuf::TextFormat to force deterministic serialization recursively
+   * including known types in google.protobuf.Any. This is much slower than hash(), and only for
+   * hashes that are persisted and so must not change between releases.
+   */
+  static std::size_t textFormatHash(const Protobuf::Message& message);
+
   static void loadFromJson(const std::string& json, Protobuf::Message& message,
                            ProtobufMessage::ValidationVisitor& validation_visitor);
   /**
@@ -63,6 +63,15 @@ public:
     }
     return io_handle_.sendmsg(slices, num_slice, flags, self_ip, peer_address);
   }
+  Api::IoCallUint64Result sendmmsg(const Network::RawSliceArrays& slices, int flags,
+                                   const Envoy::Network::Address::Ip* self_ip,
+                                   const Network::Address::Instance& peer_address) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.sendmmsg(slices, flags, self_ip, peer_address);
+  }
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override {
     if (closed_) {
@@ -46,6 +46,7 @@ RUNTIME_GUARD(envoy_reloadable_features_enable_grpc_async_client_cache);
 RUNTIME_GUARD(envoy_reloadable_features_get_route_config_factory_by_type);
 RUNTIME_GUARD(envoy_reloadable_features_handle_stream_reset_during_hcm_encoding);
 RUNTIME_GUARD(envoy_reloadable_features_http1_lazy_read_disable);
+RUNTIME_GUARD(envoy_reloadable_features_http2_align_data_frames_to_slices);
 RUNTIME_GUARD(envoy_reloadable_features_http2_allow_capacity_increase_by_settings);
 RUNTIME_GUARD(envoy_reloadable_features_http2_delay_keepalive_timeout);
 RUNTIME_GUARD(envoy_reloadable_features_http2_new_codec_wrapper);
@@ -91,6 +92,9 @@ FALSE_RUNTIME_GUARD(envoy_reloadable_features_thrift_connection_draining);
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_http2_use_oghttp2);
 // Used to track if runtime is initialized.
 FALSE_RUNTIME_GUARD(envoy_reloadable_features_runtime_initialized);
+// Flip to true once attaching streams to the least loaded client has had a burn-in period with
+// HTTP/2 and HTTP/3 upstreams.
+FALSE_RUNTIME_GUARD(envoy_reloadable_features_conn_pool_attach_to_least_loaded_client);
 
 // Block of non-boolean flags. These are deprecated. Do not add more.
 ABSL_FLAG(uint64_t, envoy_headermap_lazy_map_min_size, 3, "");  // NOLINT
@@ -80,66 +80,72 @@ void StatMerger::mergeCounters(const Protobuf::Map<std::string, uint64_t>& count
     const std::string& name = counter.first;
     StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
     StatName stat_name = dynamic_context.makeDynamicStatName(name, dynamic_map);
-    temp_scope_->counterFromStatName(stat_name).add(counter.second);
+    mergeCounter(stat_name, counter.second);
   }
 }
 
+void StatMerger::mergeCounter(StatName stat_name, uint64_t delta) {
+  temp_scope_->counterFromStatName(stat_name).add(delta);
+}
+
 void StatMerger::mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                              const DynamicsMap& dynamic_map) {
   for (const auto& gauge : gauges) {
-    // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
-    // most common.
-    //
-    // 1. Child thinks gauge is Accumulate : data is combined in
-    //    gauge_ref.add() below.
-    // 2. Child thinks gauge is NeverImport: we skip this loop entry via
-    //    'continue'.
-    // 3. Child has not yet initialized gauge yet -- this merge is the
-    //    first time the child learns of the gauge. It's possible the child
-    //    will think the gauge is NeverImport due to a code change. But for
-    //    now we will leave the gauge in the child process as
-    //    import_mode==Uninitialized, and accumulate the parent value in
-    //    gauge_ref.add(). Gauges in this mode will not be included in
-    //    stats-sinks or the admin /stats calls, until the child initializes
-    //    the gauge, in which case:
-    // 3a. Child later initializes gauges as NeverImport: the parent value is
-    //     cleared during the mergeImportMode call.
-    // 3b. Child later initializes gauges as Accumulate: the parent value is
-    //     retained.
-
     StatMerger::DynamicContext dynamic_context(temp_scope_->symbolTable());
     StatName stat_name = dynamic_context.makeDynamicStatName(gauge.first, dynamic_map);
-    GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
-
-    Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
-    if (gauge_opt) {
-      import_mode = gauge_opt->get().importMode();
-      if (import_mode == Gauge::ImportMode::NeverImport) {
-        continue;
-      }
-    }
+    mergeGauge(stat_name, gauge.second);
+  }
+}
 
-    // TODO(snowp): Propagate tag values during hot restarts.
-    auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
-    if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
-      // On the first iteration through the loop, the gauge will not be loaded into the scope
-      // cache even though it might exist in another scope. Thus, we need to check again for
-      // the import status to see if we should skip this gauge.
-      //
-      // TODO(mattklein123): There is a race condition here. It's technically possible that
-      // between the time we created this stat, the stat might be created by the child as a
-      // never import stat, making the below math invalid. A follow up solution is to take the
-      // store lock starting from gaugeFromStatName() to the end of this function, but this will
-      // require adding some type of mergeGauge() function to the scope and dealing with recursive
-      // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
-      // rare.
-      continue;
+void StatMerger::mergeGauge(StatName stat_name, uint64_t value) {
+  // Merging gauges via RPC from the parent has 3 cases; case 1 and 3b are the
+  // most common.
+  //
+  // 1. Child thinks gauge is Accumulate : data is combined in
+  //    gauge_ref.add() below.
+  // 2. Child thinks gauge is NeverImport: we skip it by returning early.
+  // 3. Child has not yet initialized gauge yet -- this merge is the
+  //    first time the child learns of the gauge. It's possible the child
+  //    will think the gauge is NeverImport due to a code change. But for
+  //    now we will leave the gauge in the child process as
+  //    import_mode==Uninitialized, and accumulate the parent value in
+  //    gauge_ref.add(). Gauges in this mode will not be included in
+  //    stats-sinks or the admin /stats calls, until the child initializes
+  //    the gauge, in which case:
+  // 3a. Child later initializes gauges as NeverImport: the parent value is
+  //     cleared during the mergeImportMode call.
+  // 3b. Child later initializes gauges as Accumulate: the parent value is
+  //     retained.
+
+  GaugeOptConstRef gauge_opt = temp_scope_->findGauge(stat_name);
+
+  Gauge::ImportMode import_mode = Gauge::ImportMode::Uninitialized;
+  if (gauge_opt) {
+    import_mode = gauge_opt->get().importMode();
+    if (import_mode == Gauge::ImportMode::NeverImport) {
+      return;
     }
+  }
 
-    const uint64_t new_parent_value = gauge.second;
-    parent_gauges_.insert(gauge_ref.statName());
-    gauge_ref.setParentValue(new_parent_value);
+  // TODO(snowp): Propagate tag values during hot restarts.
+  auto& gauge_ref = temp_scope_->gaugeFromStatName(stat_name, import_mode);
+  if (gauge_ref.importMode() == Gauge::ImportMode::NeverImport) {
+    // On the first iteration through the loop, the gauge will not be loaded into the scope
+    // cache even though it might exist in another scope. Thus, we need to check again for
+    // the import status to see if we should skip this gauge.
+    //
+    // TODO(mattklein123): There is a race condition here. It's technically possible that
+    // between the time we created this stat, the stat might be created by the child as a
+    // never import stat, making the below math invalid. A follow up solution is to take the
+    // store lock starting from gaugeFromStatName() to the end of this function, but this will
+    // require adding some type of mergeGauge() function to the scope and dealing with recursive
+    // lock acquisition, etc. so we will leave this as a follow up. This race should be incredibly
+    // rare.
+    return;
   }
+
+  parent_gauges_.insert(gauge_ref.statName());
+  gauge_ref.setParentValue(value);
 }
 
 void StatMerger::retainParentGaugeValue(Stats::StatName gauge_name) {
@@ -153,5 +159,12 @@ void StatMerger::mergeStats(const Protobuf::Map<std::string, uint64_t>& counter_
   mergeGauges(gauges, dynamics);
 }
 
+bool StatMerger::mergeSnapshot(absl::string_view snapshot) {
+  return StatSnapshotDecoder::decode(
+      snapshot, temp_scope_->symbolTable(),
+      [this](StatName stat_name, uint64_t delta) { mergeCounter(stat_name, delta); },
+      [this](StatName stat_name, uint64_t value) { mergeGauge(stat_name, value); });
+}
+
 } // namespace Stats
 } // namespace Envoy
@@ -3,6 +3,7 @@
 #include "envoy/stats/store.h"
 
 #include "source/common/protobuf/protobuf.h"
+#include "source/common/stats/stat_snapshot.h"
 #include "source/common/stats/symbol_table.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -56,6 +57,18 @@ public:
                   const Protobuf::Map<std::string, uint64_t>& gauges,
                   const DynamicsMap& dynamics = DynamicsMap());
 
+  /**
+   * Merges a snapshot written by StatSnapshotBuilder, with the same semantics as
+   * mergeStats(). Each distinct name token in the snapshot is encoded into the
+   * symbol table once for the whole batch, rather than every name being parsed
+   * and encoded separately.
+   *
+   * @param snapshot the serialized snapshot.
+   * @return false if the snapshot is malformed. Stats preceding the malformed
+   *         data will already have been merged.
+   */
+  bool mergeSnapshot(absl::string_view snapshot);
+
   /**
    * Indicates that a gauge's value from the hot-restart parent should be
    * retained, combining it with the child data. By default, data is transferred
@@ -76,6 +89,8 @@ private:
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  void mergeCounter(StatName stat_name, uint64_t delta);
+  void mergeGauge(StatName stat_name, uint64_t value);
 
   StatNameHashSet parent_gauges_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
@@ -0,0 +1,300 @@
+#include "source/common/stats/stat_snapshot.h"
+
+#include <algorithm>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Stats {
+
+namespace {
+
+constexpr absl::string_view Magic = "ESNP";
+constexpr uint64_t Version = 1;
+
+void appendVarint(uint64_t number, std::string& out) {
+  while (number >= 0x80) {
+    out.push_back(static_cast<char>((number & 0x7f) | 0x80));
+    number >>= 7;
+  }
+  out.push_back(static_cast<char>(number));
+}
+
+// Bounds-checked cursor over a serialized snapshot. The snapshot comes from another process, so
+// every read is validated rather than asserted.
+class SnapshotReader {
+public:
+  explicit SnapshotReader(absl::string_view data) : data_(data) {}
+
+  bool readVarint(uint64_t& number) {
+    number = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+      if (data_.empty()) {
+        return false;
+      }
+      const uint8_t byte = static_cast<uint8_t>(data_.front());
+      data_.remove_prefix(1);
+      number |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool readBytes(uint64_t length, absl::string_view& bytes) {
+    if (length > data_.size()) {
+      return false;
+    }
+    bytes = data_.substr(0, length);
+    data_.remove_prefix(length);
+    return true;
+  }
+
+  uint64_t remaining() const { return data_.size(); }
+
+private:
+  absl::string_view data_;
+};
+
+struct DecodedToken {
+  StatName stat_name_;
+  absl::string_view str_;
+  bool is_dynamic_;
+};
+
+// Builds the StatName for a stat whose name contains an empty symbolic token. The symbol table
+// cannot encode an empty token on its own, so adjacent symbolic tokens are joined back together
+// and encoded as one, which is what StatMerger::DynamicContext does for the same names.
+SymbolTable::StoragePtr joinWithEmptyTokens(absl::Span<const DecodedToken* const> name_tokens,
+                                            SymbolTable& symbol_table) {
+  StatNamePool symbolic_pool(symbol_table);
+  StatNameVec segments;
+  std::vector<absl::string_view> symbolic_run;
+  auto flush_symbolic_run = [&]() {
+    if (!symbolic_run.empty()) {
+      segments.push_back(symbolic_pool.add(absl::StrJoin(symbolic_run, ".")));
+      symbolic_run.clear();
+    }
+  };
+  for (const DecodedToken* token : name_tokens) {
+    if (token->is_dynamic_) {
+      flush_symbolic_run();
+      segments.push_back(token->stat_name_);
+    } else {
+      symbolic_run.push_back(token->str_);
+    }
+  }
+  flush_symbolic_run();
+  return symbol_table.join(segments);
+}
+
+bool decodeStats(SnapshotReader& reader, const std::vector<DecodedToken>& tokens,
+                 SymbolTable& symbol_table, const StatSnapshotDecoder::StatFn& stat_fn) {
+  uint64_t num_stats;
+  if (!reader.readVarint(num_stats)) {
+    return false;
+  }
+
+  absl::InlinedVector<const DecodedToken*, 16> name_tokens;
+  StatNameVec segments;
+  for (uint64_t i = 0; i < num_stats; ++i) {
+    uint64_t num_name_tokens;
+    if (!reader.readVarint(num_name_tokens) || num_name_tokens > reader.remaining()) {
+      return false;
+    }
+    name_tokens.clear();
+    bool has_empty_token = false;
+    for (uint64_t j = 0; j < num_name_tokens; ++j) {
+      uint64_t index;
+      if (!reader.readVarint(index) || index >= tokens.size()) {
+        return false;
+      }
+      const DecodedToken& token = tokens[index];
+      has_empty_token |= !token.is_dynamic_ && token.str_.empty();
+      name_tokens.push_back(&token);
+    }
+    uint64_t value;
+    if (!reader.readVarint(value)) {
+      return false;
+    }
+
+    // Each token was encoded into the symbol table when the token table was read, so building
+    // the name is a lock-free concatenation of already-encoded tokens.
+    SymbolTable::StoragePtr storage;
+    if (has_empty_token) {
+      storage = joinWithEmptyTokens(name_tokens, symbol_table);
+    } else {
+      segments.clear();
+      for (const DecodedToken* token : name_tokens) {
+        segments.push_back(token->stat_name_);
+      }
+      storage = symbol_table.join(segments);
+    }
+    stat_fn(StatName(storage.get()), value);
+  }
+  return true;
+}
+
+} // namespace
+
+void StatSnapshotBuilder::addCounter(StatName stat_name, uint64_t delta) {
+  addStat(stat_name, delta, counters_);
+  ++num_counters_;
+}
+
+void StatSnapshotBuilder::addGauge(StatName stat_name, uint64_t value) {
+  addStat(stat_name, value, gauges_);
+  ++num_gauges_;
+}
+
+void StatSnapshotBuilder::addStat(StatName stat_name, uint64_t value, std::string& section) {
+  struct NameToken {
+    Symbol symbol_;
+    absl::string_view dynamic_;
+    bool is_dynamic_;
+  };
+
+  // Walk the encoded name rather than its string form. The string form is only needed to learn
+  // the text of symbols that have not been added to the token table yet.
+  absl::InlinedVector<NameToken, 16> name_tokens;
+  bool has_new_symbol = false;
+  SymbolTable::Encoding::decodeTokens(
+      stat_name,
+      [this, &name_tokens, &has_new_symbol](Symbol symbol) {
+        name_tokens.push_back({symbol, absl::string_view(), false});
+        has_new_symbol |= symbolic_tokens_.find(symbol) == symbolic_tokens_.end();
+      },
+      [&name_tokens](absl::string_view dynamic) {
+        name_tokens.push_back({0, dynamic, true});
+      });
+
+  std::string name;
+  std::vector<absl::string_view> segments;
+  if (has_new_symbol) {
+    name = symbol_table_.toString(stat_name);
+    segments = absl::StrSplit(name, '.');
+  }
+
+  appendVarint(name_tokens.size(), section);
+  size_t segment_index = 0;
+  for (const NameToken& token : name_tokens) {
+    if (token.is_dynamic_) {
+      appendVarint(dynamicToken(token.dynamic_), section);
+      // A dynamic component may contain dots, in which case it spans several segments.
+      segment_index += std::count(token.dynamic_.begin(), token.dynamic_.end(), '.') + 1;
+    } else {
+      ASSERT(!has_new_symbol || segment_index < segments.size());
+      appendVarint(symbolicToken(token.symbol_, has_new_symbol ? segments[segment_index]
+                                                               : absl::string_view()),
+                   section);
+      ++segment_index;
+    }
+  }
+  appendVarint(value, section);
+}
+
+uint32_t StatSnapshotBuilder::symbolicToken(Symbol symbol, absl::string_view token) {
+  auto iter = symbolic_tokens_.find(symbol);
+  if (iter != symbolic_tokens_.end()) {
+    return iter->second;
+  }
+  const uint32_t index = addToken(false, token);
+  symbolic_tokens_.emplace(symbol, index);
+  return index;
+}
+
+uint32_t StatSnapshotBuilder::dynamicToken(absl::string_view token) {
+  auto iter = dynamic_tokens_.find(token);
+  if (iter != dynamic_tokens_.end()) {
+    return iter->second;
+  }
+  const uint32_t index = addToken(true, token);
+  dynamic_tokens_.emplace(std::string(token), index);
+  return index;
+}
+
+uint32_t StatSnapshotBuilder::addToken(bool is_dynamic, absl::string_view token) {
+  appendVarint(is_dynamic ? 1 : 0, tokens_);
+  appendVarint(token.size(), tokens_);
+  tokens_.append(token.data(), token.size());
+  return num_tokens_++;
+}
+
+uint64_t StatSnapshotBuilder::byteSize() const {
+  std::string counts;
+  appendVarint(Version, counts);
+  appendVarint(num_tokens_, counts);
+  appendVarint(num_counters_, counts);
+  appendVarint(num_gauges_, counts);
+  return Magic.size() + counts.size() + tokens_.size() + counters_.size() + gauges_.size();
+}
+
+void StatSnapshotBuilder::serializeTo(uint8_t* buffer) const {
+  std::string varint;
+  auto append = [&buffer](absl::string_view bytes) {
+    buffer = std::copy(bytes.begin(), bytes.end(), buffer);
+  };
+  auto append_varint = [&varint, &append](uint64_t number) {
+    varint.clear();
+    appendVarint(number, varint);
+    append(varint);
+  };
+
+  append(Magic);
+  append_varint(Version);
+  append_varint(num_tokens_);
+  append(tokens_);
+  append_varint(num_counters_);
+  append(counters_);
+  append_varint(num_gauges_);
+  append(gauges_);
+}
+
+std::string StatSnapshotBuilder::serialize() const {
+  std::string snapshot(byteSize(), '\0');
+  serializeTo(reinterpret_cast<uint8_t*>(snapshot.data()));
+  return snapshot;
+}
+
+bool StatSnapshotDecoder::decode(absl::string_view snapshot, SymbolTable& symbol_table,
+                                 const StatFn& counter_fn, const StatFn& gauge_fn) {
+  SnapshotReader reader(snapshot);
+  absl::string_view magic;
+  uint64_t version;
+  if (!reader.readBytes(Magic.size(), magic) || magic != Magic || !reader.readVarint(version) ||
+      version != Version) {
+    return false;
+  }
+
+  uint64_t num_tokens;
+  if (!reader.readVarint(num_tokens) || num_tokens > reader.remaining()) {
+    return false;
+  }
+
+  // Encode every distinct token once. The pools keep the tokens' symbols referenced until all
+  // stats have been built from them.
+  StatNamePool symbolic_pool(symbol_table);
+  StatNameDynamicPool dynamic_pool(symbol_table);
+  std::vector<DecodedToken> tokens;
+  tokens.reserve(num_tokens);
+  for (uint64_t i = 0; i < num_tokens; ++i) {
+    uint64_t is_dynamic;
+    uint64_t length;
+    absl::string_view str;
+    if (!reader.readVarint(is_dynamic) || is_dynamic > 1 || !reader.readVarint(length) ||
+        !reader.readBytes(length, str)) {
+      return false;
+    }
+    tokens.push_back(
+        {is_dynamic ? dynamic_pool.add(str) : symbolic_pool.add(str), str, is_dynamic == 1});
+  }
+
+  return decodeStats(reader, tokens, symbol_table, counter_fn) &&
+         decodeStats(reader, tokens, symbol_table, gauge_fn) && reader.remaining() == 0;
+}
+
+} // namespace Stats
+} // namespace Envoy
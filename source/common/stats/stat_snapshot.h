@@ -0,0 +1,111 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Compact serialization of a set of counter deltas and gauge values, used to hand stats from a
+ * hot restart parent to its child in bulk.
+ *
+ * Stat names are not stored as strings. Each distinct name token -- a symbol, or a dynamic
+ * component -- is stored once in a token table, and each stat refers to its tokens by index,
+ * mirroring the way the symbol table represents a StatName. This keeps the snapshot small when
+ * millions of stats share a modest set of tokens, and lets the reader encode each distinct token
+ * into its own symbol table once, rather than once per stat.
+ *
+ * Layout, where every integer after the magic number is a varint:
+ *
+ *   "ESNP" version
+ *   num_tokens, then per token: is_dynamic, length, bytes
+ *   num_counters, then per counter: num_name_tokens, token indices, delta
+ *   num_gauges, then per gauge: num_name_tokens, token indices, value
+ */
+class StatSnapshotBuilder {
+public:
+  explicit StatSnapshotBuilder(const SymbolTable& symbol_table) : symbol_table_(symbol_table) {}
+
+  /**
+   * Adds a counter delta to the snapshot.
+   * @param stat_name the counter's name, in the builder's symbol table.
+   * @param delta the amount added to the counter since it was last snapshotted.
+   */
+  void addCounter(StatName stat_name, uint64_t delta);
+
+  /**
+   * Adds a gauge value to the snapshot.
+   * @param stat_name the gauge's name, in the builder's symbol table.
+   * @param value the gauge's current value.
+   */
+  void addGauge(StatName stat_name, uint64_t value);
+
+  uint64_t numCounters() const { return num_counters_; }
+  uint64_t numGauges() const { return num_gauges_; }
+
+  /**
+   * @return the number of bytes written by serializeTo().
+   */
+  uint64_t byteSize() const;
+
+  /**
+   * Writes the snapshot into buffer, which must hold at least byteSize() bytes.
+   */
+  void serializeTo(uint8_t* buffer) const;
+
+  /**
+   * @return the snapshot as a string; convenience for callers not writing into shared memory.
+   */
+  std::string serialize() const;
+
+private:
+  void addStat(StatName stat_name, uint64_t value, std::string& section);
+  uint32_t symbolicToken(Symbol symbol, absl::string_view token);
+  uint32_t dynamicToken(absl::string_view token);
+  uint32_t addToken(bool is_dynamic, absl::string_view token);
+
+  const SymbolTable& symbol_table_;
+  absl::flat_hash_map<Symbol, uint32_t> symbolic_tokens_;
+  absl::flat_hash_map<std::string, uint32_t> dynamic_tokens_;
+  uint32_t num_tokens_{};
+  std::string tokens_;
+  uint64_t num_counters_{};
+  std::string counters_;
+  uint64_t num_gauges_{};
+  std::string gauges_;
+};
+
+/**
+ * Decodes snapshots written by StatSnapshotBuilder.
+ */
+class StatSnapshotDecoder {
+public:
+  /**
+   * Called for each stat in a snapshot. The StatName is only valid for the duration of the call.
+   */
+  using StatFn = std::function<void(StatName stat_name, uint64_t value)>;
+
+  /**
+   * Decodes a snapshot into symbol_table, calling counter_fn for each counter delta and
+   * gauge_fn for each gauge.
+   *
+   * @param snapshot the serialized snapshot.
+   * @param symbol_table the symbol table in which to encode stat names.
+   * @param counter_fn called for each counter.
+   * @param gauge_fn called for each gauge.
+   * @return false if the snapshot is malformed. Stats decoded before the error was found have
+   *         already been passed to the callbacks.
+   */
+  static bool decode(absl::string_view snapshot, SymbolTable& symbol_table,
+                     const StatFn& counter_fn, const StatFn& gauge_fn);
+};
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,5 +1,8 @@
 #include "source/common/upstream/cds_api_helper.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
@@ -7,12 +10,22 @@
 
 #include "source/common/common/fmt.h"
 #include "source/common/config/resource_name.h"
+#include "source/common/protobuf/utility.h"
 
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
 namespace Upstream {
 
+namespace {
+
+// Each helper thread hashes at least this many clusters; smaller updates are hashed on the main
+// thread, since starting a thread would cost more than it saves.
+constexpr size_t MinClustersPerPrepareThread = 128;
+constexpr size_t MaxPrepareThreads = 8;
+
+} // namespace
+
 std::vector<std::string>
 CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
                              const Protobuf::RepeatedPtrField<std::string>& removed_resources,
@@ -29,31 +42,39 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   ENVOY_LOG(info, "{}: add {} cluster(s), remove {} cluster(s)", name_, added_resources.size(),
             removed_resources.size());
 
+  // Hashing a cluster only reads its config, so it is done for the whole update up front,
+  // possibly on helper threads. Creating the clusters touches main thread state, so they are
+  // still added or updated one at a time, in order, below.
+  const std::vector<uint64_t> cluster_hashes = computeClusterHashes(added_resources);
+
   std::vector<std::string> exception_msgs;
   absl::flat_hash_set<std::string> cluster_names(added_resources.size());
   bool any_applied = false;
   uint32_t added_or_updated = 0;
   uint32_t skipped = 0;
-  for (const auto& resource : added_resources) {
-    envoy::config::cluster::v3::Cluster cluster;
+  for (size_t i = 0; i < added_resources.size(); ++i) {
+    const auto& resource = added_resources[i];
+    const envoy::config::cluster::v3::Cluster* cluster = nullptr;
     TRY_ASSERT_MAIN_THREAD {
-      cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
-      if (!cluster_names.insert(cluster.name()).second) {
+      cluster =
+          &dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
+      if (!cluster_names.insert(cluster->name()).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully applied.
-        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
+        throw EnvoyException(fmt::format("duplicate cluster {} found", cluster->name()));
       }
-      if (cm_.addOrUpdateCluster(cluster, resource.get().version())) {
+      if (cm_.addOrUpdateCluster(*cluster, resource.get().version(), cluster_hashes[i])) {
         any_applied = true;
-        ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster.name());
+        ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster->name());
         ++added_or_updated;
       } else {
-        ENVOY_LOG(debug, "{}: add/update cluster '{}' skipped", name_, cluster.name());
+        ENVOY_LOG(debug, "{}: add/update cluster '{}' skipped", name_, cluster->name());
         ++skipped;
       }
     }
     END_TRY
     catch (const EnvoyException& e) {
-      exception_msgs.push_back(fmt::format("{}: {}", cluster.name(), e.what()));
+      exception_msgs.push_back(
+          fmt::format("{}: {}", cluster != nullptr ? cluster->name() : "", e.what()));
     }
   }
   for (const auto& resource_name : removed_resources) {
@@ -72,5 +93,43 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   return exception_msgs;
 }
 
+std::vector<uint64_t>
+CdsApiHelper::computeClusterHashes(const std::vector<Config::DecodedResourceRef>& added_resources) {
+  std::vector<uint64_t> cluster_hashes(added_resources.size());
+  // Each range is written by one thread only, and no cluster is shared between ranges.
+  auto hash_range = [&added_resources, &cluster_hashes](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      const auto* cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster*>(
+          &added_resources[i].get().resource());
+      if (cluster != nullptr) {
+        cluster_hashes[i] = MessageUtil::hash(*cluster);
+      }
+    }
+  };
+
+  size_t num_threads = 1;
+  if (thread_factory_.has_value()) {
+    num_threads =
+        std::min({MaxPrepareThreads, std::max<size_t>(std::thread::hardware_concurrency(), 1),
+                  std::max<size_t>(added_resources.size() / MinClustersPerPrepareThread, 1)});
+  }
+  const size_t clusters_per_thread = (added_resources.size() + num_threads - 1) / num_threads;
+
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t thread_index = 1; thread_index < num_threads; ++thread_index) {
+    const size_t begin = std::min(thread_index * clusters_per_thread, added_resources.size());
+    const size_t end = std::min(begin + clusters_per_thread, added_resources.size());
+    threads.push_back(thread_factory_->createThread(
+        [&hash_range, begin, end]() { hash_range(begin, end); }, Thread::Options{"cds_prepare"}));
+  }
+  // The main thread takes the first range rather than waiting idle.
+  hash_range(0, std::min(clusters_per_thread, added_resources.size()));
+  for (auto& thread : threads) {
+    thread->join();
+  }
+  return cluster_hashes;
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -3,7 +3,9 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/optref.h"
 #include "envoy/config/subscription.h"
+#include "envoy/thread/thread.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/common/logger.h"
@@ -19,6 +21,12 @@ namespace Upstream {
 class CdsApiHelper : Logger::Loggable<Logger::Id::upstream> {
 public:
   CdsApiHelper(ClusterManager& cm, std::string name) : cm_(cm), name_(std::move(name)) {}
+  /**
+   * As above, additionally using thread_factory to start helper threads that prepare the
+   * clusters of large updates in parallel, before they are applied in order on the main thread.
+   */
+  CdsApiHelper(ClusterManager& cm, Thread::ThreadFactory& thread_factory, std::string name)
+      : cm_(cm), thread_factory_(thread_factory), name_(std::move(name)) {}
   /**
    * onConfigUpdate handles the addition and removal of clusters by notifying the ClusterManager
    * about the cluster changes. It closely follows the onConfigUpdate API from
@@ -36,7 +44,11 @@ public:
   const std::string versionInfo() const { return system_version_info_; }
 
 private:
+  std::vector<uint64_t>
+  computeClusterHashes(const std::vector<Config::DecodedResourceRef>& added_resources);
+
   ClusterManager& cm_;
+  OptRef<Thread::ThreadFactory> thread_factory_;
   const std::string name_;
   std::string system_version_info_;
 };
@@ -11,18 +11,21 @@ namespace Upstream {
 CdsApiPtr CdsApiImpl::create(const envoy::config::core::v3::ConfigSource& cds_config,
                              const xds::core::v3::ResourceLocator* cds_resources_locator,
                              ClusterManager& cm, Stats::Scope& scope,
-                             ProtobufMessage::ValidationVisitor& validation_visitor) {
-  return CdsApiPtr{
-      new CdsApiImpl(cds_config, cds_resources_locator, cm, scope, validation_visitor)};
+                             ProtobufMessage::ValidationVisitor& validation_visitor,
+                             Thread::ThreadFactory& thread_factory) {
+  return CdsApiPtr{new CdsApiImpl(cds_config, cds_resources_locator, cm, scope, validation_visitor,
+                                  thread_factory)};
 }
 
 CdsApiImpl::CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config,
                        const xds::core::v3::ResourceLocator* cds_resources_locator,
                        ClusterManager& cm, Stats::Scope& scope,
-                       ProtobufMessage::ValidationVisitor& validation_visitor)
+                       ProtobufMessage::ValidationVisitor& validation_visitor,
+                       Thread::ThreadFactory& thread_factory)
     : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(validation_visitor,
                                                                            "name"),
-      helper_(cm, "cds"), cm_(cm), scope_(scope.createScope("cluster_manager.cds.")) {
+      helper_(cm, thread_factory, "cds"), cm_(cm),
+      scope_(scope.createScope("cluster_manager.cds.")) {
   const auto resource_name = getResourceName();
   if (cds_resources_locator == nullptr) {
     subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
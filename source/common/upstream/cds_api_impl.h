@@ -10,6 +10,7 @@
 #include "envoy/config/subscription.h"
 #include "envoy/protobuf/message_validator.h"
 #include "envoy/stats/scope.h"
+#include "envoy/thread/thread.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "source/common/config/subscription_base.h"
@@ -28,7 +29,8 @@ public:
   static CdsApiPtr create(const envoy::config::core::v3::ConfigSource& cds_config,
                           const xds::core::v3::ResourceLocator* cds_resources_locator,
                           ClusterManager& cm, Stats::Scope& scope,
-                          ProtobufMessage::ValidationVisitor& validation_visitor);
+                          ProtobufMessage::ValidationVisitor& validation_visitor,
+                          Thread::ThreadFactory& thread_factory);
 
   // Upstream::CdsApi
   void initialize() override { subscription_->start({}); }
@@ -48,7 +50,8 @@ private:
                             const EnvoyException* e) override;
   CdsApiImpl(const envoy::config::core::v3::ConfigSource& cds_config,
              const xds::core::v3::ResourceLocator* cds_resources_locator, ClusterManager& cm,
-             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor);
+             Stats::Scope& scope, ProtobufMessage::ValidationVisitor& validation_visitor,
+             Thread::ThreadFactory& thread_factory);
   void runInitializeCallbackIfAny();
 
   CdsApiHelper helper_;
@@ -674,6 +674,12 @@ void ClusterManagerImpl::applyUpdates(ClusterManagerCluster& cluster, uint32_t p
 
 bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                             const std::string& version_info) {
+  return addOrUpdateCluster(cluster, version_info, MessageUtil::hash(cluster));
+}
+
+bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                            const std::string& version_info,
+                                            const uint64_t new_hash) {
   // First we need to see if this new config is new or an update to an existing dynamic cluster.
   // We don't allow updates to statically configured clusters in the main configuration. We check
   // both the warming clusters and the active clusters to see if we need an update or the update
@@ -681,7 +687,6 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cl
   const std::string& cluster_name = cluster.name();
   const auto existing_active_cluster = active_clusters_.find(cluster_name);
   const auto existing_warming_cluster = warming_clusters_.find(cluster_name);
-  const uint64_t new_hash = MessageUtil::hash(cluster);
   if (existing_warming_cluster != warming_clusters_.end()) {
     // If the cluster is the same as the warming cluster of the same name, block the update.
     if (existing_warming_cluster->second->blockUpdate(new_hash)) {
@@ -1958,7 +1963,8 @@ ProdClusterManagerFactory::createCds(const envoy::config::core::v3::ConfigSource
                                      ClusterManager& cm) {
   // TODO(htuch): Differentiate static vs. dynamic validation visitors.
   return CdsApiImpl::create(cds_config, cds_resources_locator, cm, stats_,
-                            validation_context_.dynamicValidationVisitor());
+                            validation_context_.dynamicValidationVisitor(),
+                            context_.api().threadFactory());
 }
 
 } // namespace Upstream
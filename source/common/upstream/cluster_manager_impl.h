@@ -255,6 +255,8 @@ public:
   // Upstream::ClusterManager
   bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                           const std::string& version_info) override;
+  bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                          const std::string& version_info, uint64_t cluster_hash) override;
 
   void setPrimaryClustersInitializedCb(PrimaryClustersReadyCallback callback) override {
     init_helper_.setPrimaryClustersInitializedCb(callback);
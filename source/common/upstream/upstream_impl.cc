@@ -933,6 +933,12 @@ ClusterInfoImpl::ClusterInfoImpl(
     max_connection_duration_ = absl::nullopt;
   }
 
+  if (config.preconnect_policy().has_adaptive_preconnect()) {
+    adaptive_preconnect_target_queue_wait_ =
+        std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+            config.preconnect_policy().adaptive_preconnect().target_queue_wait()));
+  }
+
   if (config.has_eds_cluster_config()) {
     if (config.type() != envoy::config::cluster::v3::Cluster::EDS) {
       throw EnvoyException("eds_cluster_config set in a non-EDS cluster");
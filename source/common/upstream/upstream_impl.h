@@ -641,6 +641,10 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  const absl::optional<std::chrono::milliseconds>
+  adaptivePreconnectTargetQueueWait() const override {
+    return adaptive_preconnect_target_queue_wait_;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -802,6 +806,7 @@ private:
   absl::optional<std::chrono::milliseconds> max_connection_duration_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  absl::optional<std::chrono::milliseconds> adaptive_preconnect_target_queue_wait_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopeSharedPtr stats_scope_;
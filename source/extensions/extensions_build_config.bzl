@@ -166,6 +166,8 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.cgroup_memory":            "//source/extensions/resource_monitors/cgroup_memory:config",
+    "envoy.resource_monitors.cpu_pressure":             "//source/extensions/resource_monitors/cpu_pressure:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
@@ -311,6 +313,7 @@ EXTENSIONS = {
     #
     "envoy.udp_packet_writer.default":                  "//source/extensions/udp_packet_writer/default:config",
     "envoy.udp_packet_writer.gso":                      "//source/extensions/udp_packet_writer/gso:config",
+    "envoy.udp_packet_writer.mmsg":                     "//source/extensions/udp_packet_writer/mmsg:config",
 
     #
     # Formatter
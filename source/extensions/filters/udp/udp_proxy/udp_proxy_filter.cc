@@ -62,6 +62,25 @@ Network::FilterStatus UdpProxyFilter::onReceiveError(Api::IoError::IoErrorCode)
   return Network::FilterStatus::StopIteration;
 }
 
+void UdpProxyFilter::flushWritesAtEndOfIteration(ActiveSession& session) {
+  sessions_with_pending_writes_.insert(&session);
+  if (flush_pending_writes_cb_ == nullptr) {
+    flush_pending_writes_cb_ =
+        read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+            [this] { flushPendingWrites(); });
+  }
+  if (!flush_pending_writes_cb_->enabled()) {
+    flush_pending_writes_cb_->scheduleCallbackCurrentIteration();
+  }
+}
+
+void UdpProxyFilter::flushPendingWrites() {
+  for (ActiveSession* session : sessions_with_pending_writes_) {
+    session->flushWrites();
+  }
+  sessions_with_pending_writes_.clear();
+}
+
 UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
                                          Upstream::ThreadLocalCluster& cluster,
                                          SessionStorageType&& sessions)
@@ -233,7 +252,10 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
           [this] { onIdleTimer(); })),
       // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
       //       is bound until the first packet is sent to the upstream host.
-      socket_(cluster.filter_.createSocket(host)) {
+      socket_(cluster.filter_.createSocket(host)),
+      packet_writer_(
+          cluster.filter_.config_->upstreamPacketWriterFactory().createUdpPacketWriter(
+              socket_->ioHandle(), cluster.cluster_.info()->statsScope())) {
   if (!cluster_.filter_.config_->accessLogs().empty()) {
     udp_sess_stats_.emplace(
         StreamInfo::StreamInfoImpl(cluster_.filter_.config_->timeSource(), nullptr));
@@ -275,6 +297,9 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
+  if (cluster_.filter_.sessions_with_pending_writes_.erase(this) > 0) {
+    flushWrites();
+  }
   cluster_.filter_.config_->stats().downstream_sess_active_.dec();
   cluster_.cluster_.info()
       ->resourceManager(Upstream::ResourcePriority::Default)
@@ -324,12 +349,11 @@ void UdpProxyFilter::ActiveSession::onReadReady() {
       cluster_.filter_.config_->upstreamSocketConfig().prefer_gro_, packets_dropped);
   if (result == nullptr) {
     socket_->ioHandle().activateFileEvents(Event::FileReadyType::Read);
-    return;
-  }
-  if (result->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+  } else if (result->getErrorCode() != Api::IoError::IoErrorCode::Again) {
     cluster_.cluster_stats_.sess_rx_errors_.inc();
   }
-  // Flush out buffered data at the end of IO event.
+  // Flush out buffered data at the end of IO event, including when the read was limited and more
+  // packets are left to read in the next event loop iteration.
   cluster_.filter_.read_callbacks_->udpListener().flush();
 }
 
@@ -350,14 +374,32 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   // NOTE: We do not specify the local IP to use for the sendmsg call if use_original_src_ip_ is not
   //       set. We allow the OS to select the right IP based on outbound routing rules if
   //       use_original_src_ip_ is not set, else use downstream peer IP as local IP.
+  // NOTE: A batching packet writer only queues the datagram here. It is sent when the session's
+  //       writes are flushed at the end of the event loop iteration, and a failure to send it is
+  //       counted then.
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
-  if (!rc.ok()) {
-    cluster_.cluster_stats_.sess_tx_errors_.inc();
-  } else {
+  const Api::IoCallUint64Result rc =
+      packet_writer_->writePacket(buffer, local_ip, *host_->address());
+  onWriteResult(rc);
+  if (rc.ok()) {
     cluster_.cluster_stats_.sess_tx_datagrams_.inc();
     cluster_.cluster_.info()->stats().upstream_cx_tx_bytes_total_.add(buffer_length);
+    if (packet_writer_->isBatchMode()) {
+      cluster_.filter_.flushWritesAtEndOfIteration(*this);
+    }
+  }
+}
+
+void UdpProxyFilter::ActiveSession::flushWrites() { onWriteResult(packet_writer_->flush()); }
+
+void UdpProxyFilter::ActiveSession::onWriteResult(const Api::IoCallUint64Result& result) {
+  if (!result.ok()) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+  }
+  // Like the unbatched writes, datagrams which can't be sent because the socket would block are
+  // dropped rather than held until the socket is writable.
+  if (packet_writer_->isWriteBlocked()) {
+    packet_writer_->setWritable();
   }
 }
 
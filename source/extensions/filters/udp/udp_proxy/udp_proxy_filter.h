@@ -3,9 +3,11 @@
 #include "envoy/access_log/access_log.h"
 #include "envoy/config/accesslog/v3/accesslog.pb.h"
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
+#include "envoy/network/udp_packet_writer_handler.h"
 #include "envoy/stream_info/stream_info.h"
 #include "envoy/upstream/cluster_manager.h"
 
@@ -13,8 +15,10 @@
 #include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/common/empty_string.h"
 #include "source/common/common/random_generator.h"
+#include "source/common/config/utility.h"
 #include "source/common/network/socket_impl.h"
 #include "source/common/network/socket_interface.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
 #include "source/common/network/utility.h"
 #include "source/common/protobuf/utility.h"
 #include "source/common/stream_info/stream_info_impl.h"
@@ -98,6 +102,20 @@ public:
     if (!config.hash_policies().empty()) {
       hash_policy_ = std::make_unique<HashPolicyImpl>(config.hash_policies());
     }
+
+    if (config.has_upstream_packet_writer_config()) {
+      auto& factory = Config::Utility::getAndCheckFactory<Network::UdpPacketWriterFactoryFactory>(
+          config.upstream_packet_writer_config());
+      upstream_packet_writer_factory_ =
+          factory.createUdpPacketWriterFactory(config.upstream_packet_writer_config());
+      if (upstream_packet_writer_factory_ == nullptr) {
+        ExceptionUtil::throwEnvoyException(
+            fmt::format("The upstream packet writer {} is not supported by this build.",
+                        config.upstream_packet_writer_config().name()));
+      }
+    } else {
+      upstream_packet_writer_factory_ = std::make_unique<Network::UdpDefaultWriterFactory>();
+    }
   }
 
   const std::string route(const Network::Address::Instance& destination_address,
@@ -117,6 +135,9 @@ public:
     return upstream_socket_config_;
   }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() const { return access_logs_; }
+  Network::UdpPacketWriterFactory& upstreamPacketWriterFactory() const {
+    return *upstream_packet_writer_factory_;
+  }
 
 private:
   static UdpProxyDownstreamStats generateStats(const std::string& stat_prefix,
@@ -137,6 +158,7 @@ private:
   const Network::ResolvedUdpSocketConfig upstream_socket_config_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   Random::RandomGenerator& random_;
+  Network::UdpPacketWriterFactoryPtr upstream_packet_writer_factory_;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -189,9 +211,12 @@ private:
     const Network::UdpRecvData::LocalPeerAddresses& addresses() const { return addresses_; }
     const Upstream::Host& host() const { return *host_; }
     void write(const Buffer::Instance& buffer);
+    // Sends the datagrams queued by a batching upstream packet writer.
+    void flushWrites();
 
   private:
     void onIdleTimer();
+    void onWriteResult(const Api::IoCallUint64Result& result);
     void onReadReady();
     void fillStreamInfo();
 
@@ -236,6 +261,7 @@ private:
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    const Network::UdpPacketWriterPtr packet_writer_;
 
     UdpProxySessionStats session_stats_{};
     absl::optional<StreamInfo::StreamInfoImpl> udp_sess_stats_;
@@ -380,8 +406,17 @@ private:
   void onClusterAddOrUpdate(Upstream::ThreadLocalCluster& cluster) final;
   void onClusterRemoval(const std::string& cluster_name) override;
 
+  // Flushes the session's queued upstream writes at the end of the current event loop iteration,
+  // so that the datagrams a session forwards from one read of the listener socket are batched.
+  void flushWritesAtEndOfIteration(ActiveSession& session);
+  void flushPendingWrites();
+
   const UdpProxyFilterConfigSharedPtr config_;
   const Upstream::ClusterUpdateCallbacksHandlePtr cluster_update_callbacks_;
+  // Sessions with queued upstream writes. Declared before cluster_infos_, as sessions remove
+  // themselves on destruction.
+  absl::flat_hash_set<ActiveSession*> sessions_with_pending_writes_;
+  Event::SchedulableCallbackPtr flush_pending_writes_cb_;
   // Map for looking up cluster info with its name.
   absl::flat_hash_map<std::string, ClusterInfoPtr> cluster_infos_;
 };
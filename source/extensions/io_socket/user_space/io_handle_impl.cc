@@ -232,6 +232,12 @@ Api::IoCallUint64Result IoHandleImpl::sendmsg(const Buffer::RawSlice*, uint64_t,
   return Network::IoSocketError::ioResultSocketInvalidAddress();
 }
 
+Api::IoCallUint64Result IoHandleImpl::sendmmsg(const RawSliceArrays&, int,
+                                               const Network::Address::Ip*,
+                                               const Network::Address::Instance&) {
+  return Network::IoSocketError::ioResultSocketInvalidAddress();
+}
+
 Api::IoCallUint64Result IoHandleImpl::recvmsg(Buffer::RawSlice*, const uint64_t, uint32_t,
                                               RecvMsgOutput&) {
   return Network::IoSocketError::ioResultSocketInvalidAddress();
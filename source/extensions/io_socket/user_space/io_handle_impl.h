@@ -58,6 +58,9 @@ public:
   Api::IoCallUint64Result sendmsg(const Buffer::RawSlice* slices, uint64_t num_slice, int flags,
                                   const Network::Address::Ip* self_ip,
                                   const Network::Address::Instance& peer_address) override;
+  Api::IoCallUint64Result sendmmsg(const RawSliceArrays& slices, int flags,
+                                   const Network::Address::Ip* self_ip,
+                                   const Network::Address::Instance& peer_address) override;
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
   Api::IoCallUint64Result recvmmsg(RawSliceArrays& slices, uint32_t self_port,
@@ -0,0 +1,127 @@
+#include "source/extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/thread.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+namespace {
+
+constexpr absl::string_view DefaultCgroupPath = "/sys/fs/cgroup";
+
+// cgroup v1 reports an unset limit as the largest page-aligned signed 64-bit value, rather than
+// the literal "max" used by cgroup v2. Anything in that range is treated as unlimited.
+constexpr uint64_t CgroupV1UnlimitedThreshold = uint64_t(1) << 62;
+
+} // namespace
+
+CgroupMemoryStatsReader::CgroupMemoryStatsReader(Filesystem::Instance& file_system,
+                                                 const std::string& cgroup_path)
+    : file_system_(file_system) {
+  const std::string path = cgroup_path.empty() ? std::string(DefaultCgroupPath) : cgroup_path;
+  if (file_system_.fileExists(absl::StrCat(path, "/memory.current"))) {
+    usage_path_ = absl::StrCat(path, "/memory.current");
+    limit_path_ = absl::StrCat(path, "/memory.max");
+    stat_path_ = absl::StrCat(path, "/memory.stat");
+    inactive_file_key_ = "inactive_file";
+    return;
+  }
+
+  for (const std::string& v1_path : {path, absl::StrCat(path, "/memory")}) {
+    if (file_system_.fileExists(absl::StrCat(v1_path, "/memory.usage_in_bytes"))) {
+      usage_path_ = absl::StrCat(v1_path, "/memory.usage_in_bytes");
+      limit_path_ = absl::StrCat(v1_path, "/memory.limit_in_bytes");
+      stat_path_ = absl::StrCat(v1_path, "/memory.stat");
+      inactive_file_key_ = "total_inactive_file";
+      return;
+    }
+  }
+
+  throw EnvoyException(fmt::format("no cgroup memory controller found at '{}'", path));
+}
+
+uint64_t CgroupMemoryStatsReader::workingSetBytes() {
+  const uint64_t usage = readValue(usage_path_);
+  const uint64_t inactive_file = readStat(stat_path_, inactive_file_key_);
+  return usage - std::min(usage, inactive_file);
+}
+
+uint64_t CgroupMemoryStatsReader::limitBytes() {
+  const uint64_t limit = readValue(limit_path_);
+  return limit >= CgroupV1UnlimitedThreshold ? UnlimitedMemory : limit;
+}
+
+uint64_t CgroupMemoryStatsReader::readValue(const std::string& path) {
+  const std::string contents = file_system_.fileReadToEnd(path);
+  const absl::string_view value = absl::StripAsciiWhitespace(contents);
+  if (value == "max") {
+    return UnlimitedMemory;
+  }
+  uint64_t result;
+  if (!absl::SimpleAtoi(value, &result)) {
+    throw EnvoyException(fmt::format("failed to parse cgroup memory value in '{}'", path));
+  }
+  return result;
+}
+
+uint64_t CgroupMemoryStatsReader::readStat(const std::string& path, absl::string_view key) {
+  const std::string contents = file_system_.fileReadToEnd(path);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    const std::pair<absl::string_view, absl::string_view> entry = absl::StrSplit(line, ' ');
+    if (entry.first == key) {
+      uint64_t result;
+      if (!absl::SimpleAtoi(entry.second, &result)) {
+        throw EnvoyException(fmt::format("failed to parse '{}' in '{}'", key, path));
+      }
+      return result;
+    }
+  }
+  // Missing counters are treated as zero, which makes the working set equal to the usage.
+  return 0;
+}
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+    std::unique_ptr<CgroupMemoryStatsReader> stats)
+    : max_memory_(config.max_memory_bytes() > 0 ? config.max_memory_bytes()
+                                                : CgroupMemoryStatsReader::UnlimitedMemory),
+      stats_(std::move(stats)) {}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  TRY_ASSERT_MAIN_THREAD {
+    const uint64_t limit = std::min(stats_->limitBytes(), max_memory_);
+    if (limit == CgroupMemoryStatsReader::UnlimitedMemory) {
+      throw EnvoyException("cgroup has no memory limit and max_memory_bytes is not configured");
+    }
+    const uint64_t used = stats_->workingSetBytes();
+
+    Server::ResourceUsage usage;
+    usage.resource_pressure_ = used / static_cast<double>(limit);
+
+    ENVOY_LOG_MISC(trace, "CgroupMemoryMonitor: used={}, limit={}, pressure={}", used, limit,
+                   usage.resource_pressure_);
+
+    callbacks.onSuccess(usage);
+  }
+  END_TRY
+  catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+  }
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
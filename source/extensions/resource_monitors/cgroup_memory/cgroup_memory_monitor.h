@@ -0,0 +1,67 @@
+#pragma once
+
+#include <limits>
+
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Helper class for reading memory statistics of a cgroup v1 or v2 hierarchy.
+ */
+class CgroupMemoryStatsReader {
+public:
+  static constexpr uint64_t UnlimitedMemory = std::numeric_limits<uint64_t>::max();
+
+  /**
+   * @param file_system supplies the file system used to read the cgroup files.
+   * @param cgroup_path supplies the cgroup directory. The cgroup version is detected from the
+   *        files present in it.
+   * @throw EnvoyException if no memory controller is found at cgroup_path.
+   */
+  CgroupMemoryStatsReader(Filesystem::Instance& file_system, const std::string& cgroup_path);
+  virtual ~CgroupMemoryStatsReader() = default;
+
+  // Memory charged to the cgroup, excluding inactive file-backed pages which the kernel reclaims
+  // before invoking the OOM killer.
+  virtual uint64_t workingSetBytes();
+  // The cgroup memory limit, or UnlimitedMemory if the cgroup is not limited.
+  virtual uint64_t limitBytes();
+
+private:
+  uint64_t readValue(const std::string& path);
+  uint64_t readStat(const std::string& path, absl::string_view key);
+
+  Filesystem::Instance& file_system_;
+  std::string usage_path_;
+  std::string limit_path_;
+  std::string stat_path_;
+  absl::string_view inactive_file_key_;
+};
+
+/**
+ * Memory monitor which reports the working set of the enclosing cgroup relative to its limit.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig& config,
+      std::unique_ptr<CgroupMemoryStatsReader> stats);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  const uint64_t max_memory_;
+  std::unique_ptr<CgroupMemoryStatsReader> stats_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
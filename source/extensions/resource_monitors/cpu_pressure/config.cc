@@ -0,0 +1,29 @@
+#include "source/extensions/resource_monitors/cpu_pressure/config.h"
+
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/protobuf/utility.h"
+#include "source/extensions/resource_monitors/cpu_pressure/cpu_pressure_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+
+Server::ResourceMonitorPtr CpuPressureMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<CpuPressureMonitor>(config, context.api().fileSystem());
+}
+
+/**
+ * Static registration for the CPU pressure resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CpuPressureMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
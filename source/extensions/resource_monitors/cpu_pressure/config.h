@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "source/extensions/resource_monitors/common/factory_base.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+
+class CpuPressureMonitorFactory
+    : public Common::FactoryBase<
+          envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig> {
+public:
+  CpuPressureMonitorFactory() : FactoryBase("envoy.resource_monitors.cpu_pressure") {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#include "source/extensions/resource_monitors/cpu_pressure/cpu_pressure_monitor.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/fmt.h"
+#include "source/common/common/thread.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+
+namespace {
+
+constexpr absl::string_view DefaultPressureFile = "/sys/fs/cgroup/cpu.pressure";
+
+absl::string_view windowKey(
+    envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig::Window window) {
+  switch (window) {
+    PANIC_ON_PROTO_ENUM_SENTINEL_VALUES;
+  case envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig::AVG10:
+    return "avg10";
+  case envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig::AVG60:
+    return "avg60";
+  case envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig::AVG300:
+    return "avg300";
+  }
+  PANIC_DUE_TO_CORRUPT_ENUM;
+}
+
+} // namespace
+
+CpuPressureMonitor::CpuPressureMonitor(
+    const envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig& config,
+    Filesystem::Instance& file_system)
+    : pressure_file_(config.pressure_file().empty() ? std::string(DefaultPressureFile)
+                                                    : config.pressure_file()),
+      window_key_(windowKey(config.window())), file_system_(file_system) {}
+
+void CpuPressureMonitor::updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) {
+  TRY_ASSERT_MAIN_THREAD {
+    Server::ResourceUsage usage;
+    usage.resource_pressure_ = readPressure();
+
+    ENVOY_LOG_MISC(trace, "CpuPressureMonitor: {}={}, pressure={}", window_key_,
+                   usage.resource_pressure_ * 100, usage.resource_pressure_);
+
+    callbacks.onSuccess(usage);
+  }
+  END_TRY
+  catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+  }
+}
+
+double CpuPressureMonitor::readPressure() {
+  // The file has the format:
+  //   some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+  //   full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+  // where the "full" line is only present on newer kernels.
+  const std::string contents = file_system_.fileReadToEnd(pressure_file_);
+  for (absl::string_view line : absl::StrSplit(contents, '\n', absl::SkipEmpty())) {
+    if (!absl::StartsWith(line, "some ")) {
+      continue;
+    }
+    for (absl::string_view field : absl::StrSplit(line, ' ', absl::SkipEmpty())) {
+      const std::pair<absl::string_view, absl::string_view> entry = absl::StrSplit(field, '=');
+      if (entry.first != window_key_) {
+        continue;
+      }
+      double percent;
+      if (!absl::SimpleAtod(entry.second, &percent) || percent < 0) {
+        throw EnvoyException(
+            fmt::format("failed to parse {} in CPU pressure file '{}'", window_key_,
+                        pressure_file_));
+      }
+      return std::min(percent / 100, 1.0);
+    }
+  }
+  throw EnvoyException(
+      fmt::format("no '{}' value found in CPU pressure file '{}'", window_key_, pressure_file_));
+}
+
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
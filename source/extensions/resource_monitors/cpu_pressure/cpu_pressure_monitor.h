@@ -0,0 +1,36 @@
+#pragma once
+
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/server/resource_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+
+/**
+ * CPU monitor which reports the "some" line of a Linux pressure stall information (PSI) file,
+ * i.e. the share of time in which at least one runnable task was waiting for a CPU.
+ */
+class CpuPressureMonitor : public Server::ResourceMonitor {
+public:
+  CpuPressureMonitor(
+      const envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig& config,
+      Filesystem::Instance& file_system);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceUpdateCallbacks& callbacks) override;
+
+private:
+  double readPressure();
+
+  const std::string pressure_file_;
+  const absl::string_view window_key_;
+  Filesystem::Instance& file_system_;
+};
+
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
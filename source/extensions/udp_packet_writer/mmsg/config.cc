@@ -0,0 +1,23 @@
+#include "source/extensions/udp_packet_writer/mmsg/config.h"
+
+#include "envoy/extensions/udp_packet_writer/v3/udp_mmsg_batch_writer_factory.pb.validate.h"
+
+#include "source/common/protobuf/message_validator_impl.h"
+#include "source/common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+UdpPacketWriterFactoryPtr UdpMmsgBatchWriterFactoryFactory::createUdpPacketWriterFactory(
+    const envoy::config::core::v3::TypedExtensionConfig& config) {
+  const auto writer_config = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::udp_packet_writer::v3::UdpMmsgBatchWriterFactory>(
+      config.typed_config(), ProtobufMessage::getStrictValidationVisitor());
+  return std::make_unique<UdpMmsgBatchWriterFactory>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      writer_config, max_batch_size, UdpMmsgBatchWriter::DefaultMaxBatchSize));
+}
+
+REGISTER_FACTORY(UdpMmsgBatchWriterFactoryFactory, UdpPacketWriterFactoryFactory);
+
+} // namespace Network
+} // namespace Envoy
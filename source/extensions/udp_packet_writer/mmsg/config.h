@@ -0,0 +1,25 @@
+#pragma once
+
+#include "envoy/extensions/udp_packet_writer/v3/udp_mmsg_batch_writer_factory.pb.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/registry/registry.h"
+
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+class UdpMmsgBatchWriterFactoryFactory : public Network::UdpPacketWriterFactoryFactory {
+public:
+  std::string name() const override { return "envoy.udp_packet_writer.mmsg"; }
+  UdpPacketWriterFactoryPtr createUdpPacketWriterFactory(
+      const envoy::config::core::v3::TypedExtensionConfig& config) override;
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<envoy::extensions::udp_packet_writer::v3::UdpMmsgBatchWriterFactory>();
+  }
+};
+
+DECLARE_FACTORY(UdpMmsgBatchWriterFactoryFactory);
+
+} // namespace Network
+} // namespace Envoy
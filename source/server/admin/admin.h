@@ -309,6 +309,7 @@ private:
     struct OverloadState : public ThreadLocalOverloadState {
       OverloadState(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
       const OverloadActionState& getState(const std::string&) override { return inactive_; }
+      void syncActionStates() override {}
       bool tryAllocateResource(OverloadProactiveResourceName, int64_t) override { return false; }
       bool tryDeallocateResource(OverloadProactiveResourceName, int64_t) override { return false; }
       bool isResourceMonitorEnabled(OverloadProactiveResourceName) override { return false; }
@@ -67,6 +67,8 @@ protected:
   static Stats::Gauge& hotRestartGeneration(Stats::Scope& scope);
 
 private:
+  // Returns the fd that must accompany proto as SCM_RIGHTS control data, or -1 if there is none.
+  int fdToPass(const envoy::HotRestartMessage& proto) const;
   void getPassedFdIfPresent(envoy::HotRestartMessage* out, msghdr* message);
   std::unique_ptr<envoy::HotRestartMessage> parseProtoAndResetState();
   void initRecvBufIfNewMessage();
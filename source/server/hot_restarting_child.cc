@@ -1,5 +1,8 @@
 #include "source/server/hot_restarting_child.h"
 
+#include <sys/mman.h>
+
+#include "source/common/api/os_sys_calls_impl.h"
 #include "source/common/common/utility.h"
 
 namespace Envoy {
@@ -42,7 +45,7 @@ std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_accept_snapshot(true);
   sendHotRestartMessage(parent_address_, wrapped_request);
 
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
@@ -109,6 +112,13 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     hot_restart_generation_stat_name_ = hotRestartGeneration(stats_store).statName();
   }
 
+  if (stats_proto.snapshot_size() > 0) {
+    mergeSharedMemorySnapshot(stats_proto.snapshot_fd(), stats_proto.snapshot_size());
+  } else if (!stats_proto.inline_snapshot().empty()) {
+    RELEASE_ASSERT(stat_merger_->mergeSnapshot(stats_proto.inline_snapshot()),
+                   "failed to parse a hot restart stats snapshot.");
+  }
+
   // Convert the protobuf for serialized dynamic spans into the structure
   // required by StatMerger.
   Stats::StatMerger::DynamicsMap dynamics;
@@ -122,5 +132,20 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+void HotRestartingChild::mergeSharedMemorySnapshot(int fd, uint64_t size) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallPtrResult result =
+      os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps the segment alive; the fd is no longer needed either way.
+  os_sys_calls.close(fd);
+  RELEASE_ASSERT(result.return_value_ != MAP_FAILED,
+                 fmt::format("cannot map hot restart stats snapshot, errno = {}", result.errno_));
+
+  const bool merged = stat_merger_->mergeSnapshot(
+      absl::string_view(static_cast<const char*>(result.return_value_), size));
+  munmap(result.return_value_, size);
+  RELEASE_ASSERT(merged, "failed to parse a hot restart stats snapshot.");
+}
+
 } // namespace Server
 } // namespace Envoy
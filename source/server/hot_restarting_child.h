@@ -23,6 +23,10 @@ public:
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
 
 private:
+  // Maps the shared memory segment holding a stats snapshot from the parent, merges it, and
+  // releases the segment.
+  void mergeSharedMemorySnapshot(int fd, uint64_t size);
+
   const int restart_epoch_;
   bool parent_terminated_{};
   sockaddr_un parent_address_;
@@ -1,10 +1,16 @@
 #include "source/server/hot_restarting_parent.h"
 
+#include <sys/mman.h>
+
 #include "envoy/server/instance.h"
 
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/api/os_sys_calls_impl_hot_restart.h"
+#include "source/common/common/utility.h"
 #include "source/common/memory/stats.h"
 #include "source/common/network/utility.h"
 #include "source/common/stats/stat_merger.h"
+#include "source/common/stats/stat_snapshot.h"
 #include "source/common/stats/symbol_table.h"
 #include "source/common/stats/utility.h"
 #include "source/server/listener_impl.h"
@@ -56,8 +62,17 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      HotRestartMessage::Reply::Stats* stats = wrapped_reply.mutable_reply()->mutable_stats();
+      if (wrapped_request->request().stats().accept_snapshot()) {
+        internal_->exportStatsSnapshotToChild(stats);
+      } else {
+        internal_->exportStatsToChild(stats);
+      }
       sendHotRestartMessage(child_address_, wrapped_reply);
+      if (stats->snapshot_size() > 0) {
+        // The child holds its own reference to the segment now.
+        Api::OsSysCallsSingleton::get().close(stats->snapshot_fd());
+      }
       break;
     }
 
@@ -131,33 +146,104 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
   return wrapped_reply;
 }
 
+namespace {
+
+// Copies a snapshot into a shared memory segment, returning its fd, or -1 if the segment could not
+// be created. The segment is unlinked straight away; it lives on only through the returned fd and
+// the copy of it passed to the child.
+int writeSnapshotToSharedMemory(const Stats::StatSnapshotBuilder& snapshot, uint64_t size) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+
+  const std::string name = fmt::format("/envoy_stats_snapshot_{}", getpid());
+  hot_restart_os_sys_calls.shmUnlink(name.c_str());
+  const Api::SysCallIntResult open_result =
+      hot_restart_os_sys_calls.shmOpen(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (open_result.return_value_ == -1) {
+    ENVOY_LOG_MISC(warn, "cannot create hot restart stats snapshot segment {}: {}", name,
+                   errorDetails(open_result.errno_));
+    return -1;
+  }
+  const int fd = open_result.return_value_;
+  hot_restart_os_sys_calls.shmUnlink(name.c_str());
+
+  if (os_sys_calls.ftruncate(fd, size).return_value_ != -1) {
+    const Api::SysCallPtrResult mmap_result =
+        os_sys_calls.mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mmap_result.return_value_ != MAP_FAILED) {
+      snapshot.serializeTo(static_cast<uint8_t*>(mmap_result.return_value_));
+      munmap(mmap_result.return_value_, size);
+      return fd;
+    }
+  }
+  ENVOY_LOG_MISC(warn, "cannot size or map hot restart stats snapshot segment {}", name);
+  os_sys_calls.close(fd);
+  return -1;
+}
+
+} // namespace
+
 // TODO(fredlas) if there are enough stats for stat name length to become an issue, this current
 // implementation can negate the benefit of symbolized stat names by periodically reaching the
 // magnitude of memory usage that they are meant to avoid, since this map holds full-string
 // names. The problem can be solved by splitting the export up over many chunks.
 void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
-  server_->stats().forEachSinkedGauge(nullptr, [this, stats](Stats::Gauge& gauge) mutable {
+  forEachStatToExport(
+      [this, stats](Stats::Gauge& gauge) {
+        const std::string name = gauge.name();
+        (*stats->mutable_gauges())[name] = gauge.value();
+        recordDynamics(stats, name, gauge.statName());
+      },
+      [this, stats](Stats::Counter& counter, uint64_t delta) {
+        const std::string name = counter.name();
+        (*stats->mutable_counter_deltas())[name] = delta;
+        recordDynamics(stats, name, counter.statName());
+      });
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+}
+
+void HotRestartingParent::Internal::exportStatsSnapshotToChild(
+    HotRestartMessage::Reply::Stats* stats) {
+  Stats::StatSnapshotBuilder snapshot(server_->stats().symbolTable());
+  forEachStatToExport(
+      [&snapshot](Stats::Gauge& gauge) { snapshot.addGauge(gauge.statName(), gauge.value()); },
+      [&snapshot](Stats::Counter& counter, uint64_t delta) {
+        snapshot.addCounter(counter.statName(), delta);
+      });
+
+  const uint64_t size = snapshot.byteSize();
+  const int fd = writeSnapshotToSharedMemory(snapshot, size);
+  if (fd != -1) {
+    stats->set_snapshot_size(size);
+    stats->set_snapshot_fd(fd);
+  } else {
+    // The counters have already been latched, so the deltas must reach the child some other way.
+    stats->set_inline_snapshot(snapshot.serialize());
+  }
+  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  stats->set_num_connections(server_->listenerManager().numConnections());
+}
+
+void HotRestartingParent::Internal::forEachStatToExport(
+    const std::function<void(Stats::Gauge&)>& gauge_fn,
+    const std::function<void(Stats::Counter&, uint64_t)>& counter_fn) {
+  server_->stats().forEachSinkedGauge(nullptr, [&gauge_fn](Stats::Gauge& gauge) {
     if (gauge.used()) {
-      const std::string name = gauge.name();
-      (*stats->mutable_gauges())[name] = gauge.value();
-      recordDynamics(stats, name, gauge.statName());
+      gauge_fn(gauge);
     }
   });
 
-  server_->stats().forEachSinkedCounter(nullptr, [this, stats](Stats::Counter& counter) mutable {
+  server_->stats().forEachSinkedCounter(nullptr, [&counter_fn](Stats::Counter& counter) {
     if (counter.used()) {
       // The hot restart parent is expected to have stopped its normal stat exporting (and so
       // latching) by the time it begins exporting to the hot restart child.
       uint64_t latched_value = counter.latch();
       if (latched_value > 0) {
-        const std::string name = counter.name();
-        (*stats->mutable_counter_deltas())[name] = latched_value;
-        recordDynamics(stats, name, counter.statName());
+        counter_fn(counter, latched_value);
       }
     }
   });
-  stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
-  stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
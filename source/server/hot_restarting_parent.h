@@ -30,11 +30,20 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Like exportStatsToChild(), but for children that set accept_snapshot: the stats are written
+    // as a Stats::StatSnapshotBuilder snapshot into a shared memory segment whose fd is placed in
+    // 'stats', and which the caller must close once the reply has been sent.
+    void exportStatsSnapshotToChild(envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
 
   private:
+    // Calls gauge_fn for each used gauge, and counter_fn with the latched delta of each counter
+    // that changed since the last export.
+    void forEachStatToExport(const std::function<void(Stats::Gauge&)>& gauge_fn,
+                             const std::function<void(Stats::Counter&, uint64_t)>& counter_fn);
+
     Server::Instance* const server_{};
   };
 
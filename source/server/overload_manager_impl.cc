@@ -1,5 +1,6 @@
 #include "source/server/overload_manager_impl.h"
 
+#include <atomic>
 #include <chrono>
 
 #include "envoy/common/exception.h"
@@ -20,6 +21,39 @@
 namespace Envoy {
 namespace Server {
 
+/**
+ * Action states shared between the main thread and the workers when share_action_states is
+ * enabled. The main thread publishes each state as soon as it is computed and bumps the
+ * generation; workers copy all states into their thread-local array when they observe a new
+ * generation, so that references returned by getState() are only ever written by their own thread.
+ */
+class SharedOverloadActionStates {
+public:
+  explicit SharedOverloadActionStates(size_t size) : states_(size) {
+    for (auto& state : states_) {
+      state.store(UnitFloat::min().value(), std::memory_order_relaxed);
+    }
+  }
+
+  void publish(NamedOverloadActionSymbolTable::Symbol action, OverloadActionState state) {
+    states_[action.index()].store(state.value().value(), std::memory_order_relaxed);
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+
+  uint64_t generation() const { return generation_.load(std::memory_order_acquire); }
+
+  void copyTo(std::vector<OverloadActionState>& actions) const {
+    ASSERT(actions.size() == states_.size());
+    for (size_t i = 0; i < states_.size(); ++i) {
+      actions[i] = OverloadActionState(UnitFloat(states_[i].load(std::memory_order_relaxed)));
+    }
+  }
+
+private:
+  std::vector<std::atomic<float>> states_;
+  std::atomic<uint64_t> generation_{0};
+};
+
 /**
  * Thread-local copy of the state of each configured overload action.
  */
@@ -28,10 +62,11 @@ public:
   explicit ThreadLocalOverloadStateImpl(
       const NamedOverloadActionSymbolTable& action_symbol_table,
       std::shared_ptr<absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>&
-          proactive_resources)
+          proactive_resources,
+      std::shared_ptr<const SharedOverloadActionStates> shared_states)
       : action_symbol_table_(action_symbol_table),
         actions_(action_symbol_table.size(), OverloadActionState(UnitFloat::min())),
-        proactive_resources_(proactive_resources) {}
+        proactive_resources_(proactive_resources), shared_states_(std::move(shared_states)) {}
 
   const OverloadActionState& getState(const std::string& action) override {
     if (const auto symbol = action_symbol_table_.lookup(action); symbol != absl::nullopt) {
@@ -40,8 +75,28 @@ public:
     return always_inactive_;
   }
 
-  void setState(NamedOverloadActionSymbolTable::Symbol action, OverloadActionState state) {
-    actions_[action.index()] = state;
+  void syncActionStates() override {
+    if (shared_states_ == nullptr) {
+      return;
+    }
+    const uint64_t generation = shared_states_->generation();
+    if (generation != synced_generation_) {
+      shared_states_->copyTo(actions_);
+      synced_generation_ = generation;
+    }
+  }
+
+  void setStates(const absl::flat_hash_map<NamedOverloadActionSymbolTable::Symbol,
+                                           OverloadActionState>& updates) {
+    if (shared_states_ != nullptr) {
+      // The shared states already include these updates and possibly newer ones, which must not
+      // be overwritten with the older values carried by this update.
+      syncActionStates();
+      return;
+    }
+    for (const auto& [action, state] : updates) {
+      actions_[action.index()] = state;
+    }
   }
 
   bool tryAllocateResource(OverloadProactiveResourceName resource_name,
@@ -82,6 +137,8 @@ private:
   std::vector<OverloadActionState> actions_;
   std::shared_ptr<absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>
       proactive_resources_;
+  const std::shared_ptr<const SharedOverloadActionStates> shared_states_;
+  uint64_t synced_generation_{0};
 };
 
 const OverloadActionState ThreadLocalOverloadStateImpl::always_inactive_{UnitFloat::min()};
@@ -307,6 +364,7 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     : started_(false), dispatcher_(dispatcher), tls_(slot_allocator),
       refresh_interval_(
           std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))),
+      share_action_states_(config.share_action_states()),
       proactive_resources_(
           std::make_unique<
               absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>()) {
@@ -399,9 +457,15 @@ void OverloadManagerImpl::start() {
   ASSERT(!started_);
   started_ = true;
 
+  // The symbol table can no longer grow once started, so the shared states can be sized here.
+  if (share_action_states_) {
+    shared_action_states_ =
+        std::make_shared<SharedOverloadActionStates>(action_symbol_table_.size());
+  }
+
   tls_.set([this](Event::Dispatcher&) {
-    return std::make_shared<ThreadLocalOverloadStateImpl>(action_symbol_table_,
-                                                          proactive_resources_);
+    return std::make_shared<ThreadLocalOverloadStateImpl>(
+        action_symbol_table_, proactive_resources_, shared_action_states_);
   });
 
   if (resources_.empty()) {
@@ -501,6 +565,9 @@ void OverloadManagerImpl::updateResourcePressure(const std::string& resource, do
       // causes the action to have value B, B would have been the result for whichever order the
       // updates to resources 1 and 2 came in.
       state_updates_to_flush_.insert_or_assign(action, state);
+      if (shared_action_states_ != nullptr) {
+        shared_action_states_->publish(action, state);
+      }
       auto [callbacks_start, callbacks_end] = action_to_callbacks_.equal_range(action);
       std::for_each(callbacks_start, callbacks_end, [&](ActionToCallbackMap::value_type& cb_entry) {
         callbacks_to_flush_.insert_or_assign(&cb_entry.second, state);
@@ -528,9 +595,7 @@ void OverloadManagerImpl::flushResourceUpdates() {
 
     tls_.runOnAllThreads(
         [updates = std::move(shared_updates)](OptRef<ThreadLocalOverloadStateImpl> overload_state) {
-          for (const auto& [action, state] : *updates) {
-            overload_state->setState(action, state);
-          }
+          overload_state->setStates(*updates);
         });
   }
 
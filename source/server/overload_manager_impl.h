@@ -102,6 +102,7 @@ private:
   std::vector<std::string> names_;
 };
 
+class SharedOverloadActionStates;
 class ThreadLocalOverloadStateImpl;
 
 class OverloadManagerImpl : Logger::Loggable<Logger::Id::main>, public OverloadManager {
@@ -171,6 +172,8 @@ private:
   ThreadLocal::TypedSlot<ThreadLocalOverloadStateImpl> tls_;
   NamedOverloadActionSymbolTable action_symbol_table_;
   const std::chrono::milliseconds refresh_interval_;
+  const bool share_action_states_;
+  std::shared_ptr<SharedOverloadActionStates> shared_action_states_;
   Event::TimerPtr timer_;
   absl::node_hash_map<std::string, Resource> resources_;
   std::shared_ptr<absl::node_hash_map<OverloadProactiveResourceName, ProactiveResource>>
@@ -0,0 +1,88 @@
+#include <memory>
+#include <vector>
+
+#include "source/common/common/mpsc_ring.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+TEST(MpscRingTest, PushAndPopInOrder) {
+  MpscRing<int> ring(4);
+  EXPECT_EQ(4U, ring.capacity());
+  int value = 0;
+  EXPECT_FALSE(ring.pop(value));
+
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(ring.push(int(i)));
+  }
+  // Full.
+  EXPECT_FALSE(ring.push(4));
+
+  EXPECT_TRUE(ring.pop(value));
+  EXPECT_EQ(0, value);
+  // A popped slot can be reused on the next lap.
+  EXPECT_TRUE(ring.push(4));
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_TRUE(ring.pop(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(MpscRingTest, FailedPushDoesNotMoveFromValue) {
+  MpscRing<std::unique_ptr<int>> ring(1);
+  EXPECT_TRUE(ring.push(std::make_unique<int>(1)));
+  auto value = std::make_unique<int>(2);
+  EXPECT_FALSE(ring.push(std::move(value)));
+  ASSERT_NE(nullptr, value);
+
+  std::unique_ptr<int> popped;
+  EXPECT_TRUE(ring.pop(popped));
+  EXPECT_EQ(1, *popped);
+  EXPECT_TRUE(ring.push(std::move(value)));
+}
+
+TEST(MpscRingTest, RejectsCapacityWhichIsNotAPowerOfTwo) {
+  EXPECT_DEATH(MpscRing<int>(3), "capacity must be a power of two");
+  EXPECT_DEATH(MpscRing<int>(0), "capacity must be a power of two");
+}
+
+// Producers push increasing values and the consumer checks that each producer's values arrive
+// exactly once and in order.
+TEST(MpscRingTest, ConcurrentProducers) {
+  constexpr int NumProducers = 4;
+  constexpr int ValuesPerProducer = 20000;
+  MpscRing<std::pair<int, int>> ring(64);
+
+  std::vector<Thread::ThreadPtr> producers;
+  for (int producer = 0; producer < NumProducers; ++producer) {
+    producers.push_back(Thread::threadFactoryForTest().createThread([&ring, producer]() {
+      for (int i = 0; i < ValuesPerProducer;) {
+        if (ring.push(std::make_pair(producer, i))) {
+          ++i;
+        }
+      }
+    }));
+  }
+
+  std::vector<int> next(NumProducers, 0);
+  for (int received = 0; received < NumProducers * ValuesPerProducer;) {
+    std::pair<int, int> value;
+    if (ring.pop(value)) {
+      ASSERT_EQ(next[value.first], value.second);
+      ++next[value.first];
+      ++received;
+    }
+  }
+  for (auto& producer : producers) {
+    producer->join();
+  }
+  EXPECT_EQ(std::vector<int>(NumProducers, ValuesPerProducer), next);
+}
+
+} // namespace
+} // namespace Envoy
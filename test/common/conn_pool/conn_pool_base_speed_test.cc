@@ -0,0 +1,153 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures stream churn on a single host's pool holding 1000 concurrent streams, spread over
+// connections of different concurrency with a third of their capacity unused, with streams
+// attached to the most recently ready client or to the least loaded one. Each iteration closes
+// one stream and opens another.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "source/common/conn_pool/conn_pool_base.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/test_runtime.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+constexpr uint32_t NumStreams = 1000;
+// Connections are created for this many streams, leaving spare capacity to choose from.
+constexpr uint32_t NumInitialStreams = NumStreams * 3 / 2;
+
+class SpeedTestActiveClient : public ActiveClient {
+public:
+  SpeedTestActiveClient(ConnPoolImplBase& parent, uint32_t concurrent_stream_limit)
+      : ActiveClient(parent, 0, concurrent_stream_limit) {}
+
+  void close() override { onEvent(Network::ConnectionEvent::LocalClose); }
+  uint64_t id() const override { return 1; }
+  bool closingWithIncompleteStream() const override { return false; }
+  uint32_t numActiveStreams() const override { return active_streams_; }
+  absl::optional<Http::Protocol> protocol() const override { return absl::nullopt; }
+  void onEvent(Network::ConnectionEvent event) override {
+    parent_.onConnectionEvent(*this, "", event);
+  }
+
+  uint32_t active_streams_{};
+};
+
+class SpeedTestPendingStream : public PendingStream {
+public:
+  SpeedTestPendingStream(ConnPoolImplBase& parent, AttachContext& context)
+      : PendingStream(parent, false), context_(context) {}
+  AttachContext& context() override { return context_; }
+  AttachContext& context_;
+};
+
+class SpeedTestConnPool : public ConnPoolImplBase {
+public:
+  SpeedTestConnPool(Upstream::HostConstSharedPtr host, Event::Dispatcher& dispatcher,
+                    Upstream::ClusterConnectivityState& state, uint32_t concurrent_stream_limit)
+      : ConnPoolImplBase(host, Upstream::ResourcePriority::Default, dispatcher, nullptr, nullptr,
+                         state),
+        concurrent_stream_limit_(concurrent_stream_limit) {}
+  ~SpeedTestConnPool() override { destructAllConnections(); }
+
+  ConnectionPool::Cancellable* newPendingStream(AttachContext& context, bool) override {
+    return addPendingStream(std::make_unique<SpeedTestPendingStream>(*this, context));
+  }
+  ActiveClientPtr instantiateActiveClient() override {
+    auto client = std::make_unique<SpeedTestActiveClient>(*this, concurrent_stream_limit_);
+    client->real_host_description_ = host();
+    clients_.push_back(client.get());
+    return client;
+  }
+  void onPoolFailure(const Upstream::HostDescriptionConstSharedPtr&, absl::string_view,
+                     ConnectionPool::PoolFailureReason, AttachContext&) override {}
+  void onPoolReady(ActiveClient& client, AttachContext&) override {
+    auto& speed_test_client = static_cast<SpeedTestActiveClient&>(client);
+    speed_test_client.active_streams_++;
+    last_ready_client_ = &speed_test_client;
+  }
+
+  const uint32_t concurrent_stream_limit_;
+  std::vector<SpeedTestActiveClient*> clients_;
+  SpeedTestActiveClient* last_ready_client_{};
+};
+
+void streamChurn(::benchmark::State& state) {
+  const uint32_t concurrent_stream_limit = state.range(0);
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.conn_pool_attach_to_least_loaded_client",
+                               state.range(1) ? "true" : "false"}});
+
+  NiceMock<Event::MockDispatcher> dispatcher;
+  auto cluster = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  cluster->resetResourceManager(NumInitialStreams, NumInitialStreams, NumInitialStreams, 1, 1,
+                                NumInitialStreams);
+  Upstream::HostSharedPtr host =
+      Upstream::makeTestHost(cluster, "tcp://127.0.0.1:80", dispatcher.timeSource());
+  Upstream::ClusterConnectivityState connectivity_state;
+  // Owned by the pool.
+  new NiceMock<Event::MockSchedulableCallback>(&dispatcher);
+  SpeedTestConnPool pool(host, dispatcher, connectivity_state, concurrent_stream_limit);
+  AttachContext context;
+
+  // Queue the initial streams, connect the clients created for them, then close the streams
+  // beyond NumStreams.
+  for (uint32_t i = 0; i < NumInitialStreams; ++i) {
+    pool.newStreamImpl(context, false);
+  }
+  std::vector<SpeedTestActiveClient*> streams;
+  streams.reserve(NumInitialStreams);
+  for (SpeedTestActiveClient* client : std::vector<SpeedTestActiveClient*>(pool.clients_)) {
+    client->onEvent(Network::ConnectionEvent::Connected);
+    for (uint32_t i = 0; i < client->active_streams_; ++i) {
+      streams.push_back(client);
+    }
+  }
+  RELEASE_ASSERT(streams.size() == NumInitialStreams, "");
+  while (streams.size() > NumStreams) {
+    streams.back()->active_streams_--;
+    pool.onStreamClosed(*streams.back(), false);
+    streams.pop_back();
+  }
+
+  size_t next = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    SpeedTestActiveClient* client = streams[next];
+    client->active_streams_--;
+    pool.onStreamClosed(*client, false);
+    pool.newStreamImpl(context, false);
+    streams[next] = pool.last_ready_client_;
+    next = (next + 1) % NumStreams;
+  }
+
+  uint32_t max_streams = 0;
+  for (const SpeedTestActiveClient* client : pool.clients_) {
+    max_streams = std::max(max_streams, client->active_streams_);
+  }
+  state.counters["connections"] = pool.clients_.size();
+  state.counters["max_streams_per_connection"] = max_streams;
+}
+
+BENCHMARK(streamChurn)
+    ->Args({10, false})
+    ->Args({10, true})
+    ->Args({100, false})
+    ->Args({100, true})
+    ->Args({1000, false})
+    ->Args({1000, true});
+
+} // namespace
+} // namespace ConnectionPool
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/mocks/upstream/host.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -16,6 +17,7 @@ using testing::AnyNumber;
 using testing::HasSubstr;
 using testing::Invoke;
 using testing::InvokeWithoutArgs;
+using testing::Ref;
 using testing::Return;
 
 class TestActiveClient : public ActiveClient {
@@ -134,6 +136,106 @@ public:
   std::vector<TestActiveClient*> clients_;
 };
 
+// Enables attaching streams to the least loaded client before the pool is created.
+class LeastLoadedClientRuntime {
+public:
+  LeastLoadedClientRuntime() {
+    scoped_runtime_.mergeValues(
+        {{"envoy.reloadable_features.conn_pool_attach_to_least_loaded_client", "true"}});
+  }
+
+  TestScopedRuntime scoped_runtime_;
+};
+
+class ConnPoolImplBaseLeastLoadedTest : public LeastLoadedClientRuntime,
+                                        public ConnPoolImplBaseTest {
+public:
+  // Leaves two Ready clients with three concurrent streams each: clients_[0], with two streams and
+  // at the front of the ready list, and clients_[1], with one stream.
+  void setupTwoReadyClients() {
+    concurrent_streams_ = 3;
+    // The fourth stream exceeds the first client's capacity, so a second client is created.
+    EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+    for (int i = 0; i < 4; ++i) {
+      pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+    }
+    ASSERT_EQ(2, clients_.size());
+
+    EXPECT_CALL(pool_, onPoolReady).Times(4);
+    clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+    EXPECT_EQ(ActiveClient::State::Busy, clients_[0]->state());
+    clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+    EXPECT_EQ(ActiveClient::State::Ready, clients_[1]->state());
+
+    --clients_[0]->active_streams_;
+    pool_.onStreamClosed(*clients_[0], false);
+    EXPECT_EQ(ActiveClient::State::Ready, clients_[0]->state());
+    CHECK_STATE(3 /*active*/, 0 /*pending*/, 3 /*connecting capacity*/);
+  }
+};
+
+class ConnPoolImplBaseAdaptivePreconnectTest : public testing::Test {
+public:
+  ConnPoolImplBaseAdaptivePreconnectTest()
+      : upstream_ready_cb_(new NiceMock<Event::MockSchedulableCallback>(&dispatcher_)) {
+    cluster_->resetResourceManager(1024, 1024, 1024, 1, 1);
+    // Any connection latency exceeds the target, so preconnecting starts with the first ramp.
+    ON_CALL(*cluster_, adaptivePreconnectTargetQueueWait)
+        .WillByDefault(Return(std::chrono::milliseconds(0)));
+    pool_ = std::make_unique<TestConnPoolImplBase>(host_, Upstream::ResourcePriority::Default,
+                                                   dispatcher_, nullptr, nullptr, state_);
+    ON_CALL(*pool_, instantiateActiveClient).WillByDefault(Invoke([&]() -> ActiveClientPtr {
+      auto ret = std::make_unique<NiceMock<TestActiveClient>>(*pool_, 100, 1,
+                                                              /*supports_early_data=*/false);
+      clients_.push_back(ret.get());
+      ret->real_host_description_ = descr_;
+      return ret;
+    }));
+    ON_CALL(*pool_, onPoolReady(_, _))
+        .WillByDefault(Invoke([](ActiveClient& client, AttachContext&) {
+          TestActiveClient::incrementActiveStreams(client);
+        }));
+  }
+
+  // Streams arrive 10ms apart on connections taking 100ms to establish. Leaves clients_[0] and
+  // clients_[1] with a stream each, and clients_[2], preconnected for the ramp, Ready and idle.
+  void rampUp() {
+    EXPECT_CALL(*pool_, instantiateActiveClient);
+    pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+    time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+    clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+    EXPECT_EQ(ActiveClient::State::Busy, clients_[0]->state());
+    EXPECT_EQ(0U, cluster_->stats_.upstream_cx_adaptive_preconnect_.value());
+
+    // Besides the connection the second stream needs, one more is established for the streams
+    // expected to arrive while it connects.
+    time_system_.advanceTimeWait(std::chrono::milliseconds(10));
+    EXPECT_CALL(*pool_, instantiateActiveClient).Times(2);
+    pool_->newStreamImpl(context_, /*can_send_early_data=*/false);
+    CHECK_STATE(1 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+    EXPECT_EQ(1U, cluster_->stats_.upstream_cx_adaptive_preconnect_.value());
+
+    time_system_.advanceTimeWait(std::chrono::milliseconds(100));
+    clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+    clients_[2]->onEvent(Network::ConnectionEvent::Connected);
+    EXPECT_EQ(ActiveClient::State::Busy, clients_[1]->state());
+    EXPECT_EQ(ActiveClient::State::Ready, clients_[2]->state());
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Upstream::ClusterConnectivityState state_;
+  std::shared_ptr<NiceMock<Upstream::MockHostDescription>> descr_{
+      new NiceMock<Upstream::MockHostDescription>()};
+  std::shared_ptr<Upstream::MockClusterInfo> cluster_{new NiceMock<Upstream::MockClusterInfo>()};
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Event::MockSchedulableCallback>* upstream_ready_cb_;
+  Upstream::HostSharedPtr host_{
+      Upstream::makeTestHost(cluster_, "tcp://127.0.0.1:80", dispatcher_.timeSource())};
+  std::unique_ptr<TestConnPoolImplBase> pool_;
+  AttachContext context_;
+  std::vector<TestActiveClient*> clients_;
+};
+
 class ConnPoolImplDispatcherBaseTest : public testing::Test {
 public:
   ConnPoolImplDispatcherBaseTest()
@@ -473,6 +575,161 @@ TEST_F(ConnPoolImplDispatcherBaseTest, NoAvailableStreams) {
 }
 
 // Remote close simulates the peer closing the connection.
+TEST_F(ConnPoolImplBaseTest, ActiveClientLoadIndex) {
+  std::vector<std::unique_ptr<TestActiveClient>> clients;
+  for (int i = 0; i < 3; ++i) {
+    clients.push_back(std::make_unique<NiceMock<TestActiveClient>>(pool_, 100, 10, false));
+  }
+  ActiveClientLoadIndex index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(nullptr, index.leastLoaded());
+  EXPECT_TRUE(index.idleClients().empty());
+
+  // Of equally loaded clients, the most recently added one is picked.
+  for (auto& client : clients) {
+    index.add(*client);
+  }
+  EXPECT_EQ(clients[2].get(), index.leastLoaded());
+  EXPECT_EQ(3, index.idleClients().size());
+
+  clients[2]->attached_streams_++;
+  index.onLoadIncremented(*clients[2]);
+  EXPECT_EQ(clients[1].get(), index.leastLoaded());
+  clients[1]->attached_streams_++;
+  index.onLoadIncremented(*clients[1]);
+  EXPECT_EQ(clients[0].get(), index.leastLoaded());
+  clients[0]->attached_streams_++;
+  index.onLoadIncremented(*clients[0]);
+  EXPECT_EQ(clients[0].get(), index.leastLoaded());
+  EXPECT_TRUE(index.idleClients().empty());
+
+  // Clients can be added with any load, and are ordered among the existing buckets.
+  index.remove(*clients[1]);
+  clients[1]->attached_streams_ = 5;
+  index.add(*clients[1]);
+  index.remove(*clients[0]);
+  clients[0]->attached_streams_ = 3;
+  index.add(*clients[0]);
+  EXPECT_EQ(clients[2].get(), index.leastLoaded());
+  index.remove(*clients[2]);
+  EXPECT_EQ(clients[0].get(), index.leastLoaded());
+
+  // A client whose load drops below the least loaded one takes its place.
+  clients[1]->attached_streams_--;
+  index.onLoadDecremented(*clients[1]);
+  clients[1]->attached_streams_--;
+  index.onLoadDecremented(*clients[1]);
+  EXPECT_EQ(clients[1].get(), index.leastLoaded());
+  clients[1]->attached_streams_--;
+  index.onLoadDecremented(*clients[1]);
+  EXPECT_EQ(clients[1].get(), index.leastLoaded());
+
+  index.remove(*clients[0]);
+  index.remove(*clients[1]);
+  EXPECT_TRUE(index.empty());
+}
+
+// By default, streams go to the most recently ready client.
+TEST_F(ConnPoolImplBaseTest, AttachToMostRecentlyReadyClient) {
+  concurrent_streams_ = 3;
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  for (int i = 0; i < 4; ++i) {
+    pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  }
+  EXPECT_CALL(pool_, onPoolReady).Times(4);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  clients_[1]->onEvent(Network::ConnectionEvent::Connected);
+  --clients_[0]->active_streams_;
+  pool_.onStreamClosed(*clients_[0], false);
+
+  EXPECT_CALL(pool_, onPoolReady(Ref(*clients_[0]), _));
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseLeastLoadedTest, AttachToLeastLoadedClient) {
+  setupTwoReadyClients();
+
+  // clients_[1] is less loaded even though clients_[0] became ready more recently.
+  EXPECT_CALL(pool_, onPoolReady(Ref(*clients_[1]), _))
+      .WillOnce(Invoke([](ActiveClient& client, AttachContext&) {
+        TestActiveClient::incrementActiveStreams(client);
+      }));
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+
+  // Both clients now have two streams, and clients_[1] moved most recently.
+  EXPECT_CALL(pool_, onPoolReady(Ref(*clients_[1]), _))
+      .WillOnce(Invoke([](ActiveClient& client, AttachContext&) {
+        TestActiveClient::incrementActiveStreams(client);
+      }));
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(ActiveClient::State::Busy, clients_[1]->state());
+
+  EXPECT_CALL(pool_, onPoolReady(Ref(*clients_[0]), _));
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  pool_.destructAllConnections();
+}
+
+// Closing a stream makes its client the least loaded one again.
+TEST_F(ConnPoolImplBaseLeastLoadedTest, LeastLoadedClientAfterStreamClose) {
+  setupTwoReadyClients();
+
+  clients_[0]->active_streams_ -= 2;
+  pool_.onStreamClosed(*clients_[0], false);
+  pool_.onStreamClosed(*clients_[0], false);
+
+  EXPECT_CALL(pool_, onPoolReady(Ref(*clients_[0]), _));
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  pool_.destructAllConnections();
+}
+
+// Draining closes the idle clients found through the index, and drains the others.
+TEST_F(ConnPoolImplBaseLeastLoadedTest, DrainClosesIdleClients) {
+  setupTwoReadyClients();
+
+  clients_[0]->active_streams_ -= 2;
+  pool_.onStreamClosed(*clients_[0], false);
+  pool_.onStreamClosed(*clients_[0], false);
+
+  pool_.drainConnectionsImpl(DrainBehavior::DrainExistingConnections);
+  EXPECT_EQ(ActiveClient::State::Closed, clients_[0]->state());
+  EXPECT_EQ(ActiveClient::State::Draining, clients_[1]->state());
+  pool_.destructAllConnections();
+}
+
+// A stream arriving during a ramp finds a preconnected connection, and another is preconnected
+// for the streams after it.
+TEST_F(ConnPoolImplBaseAdaptivePreconnectTest, PreconnectsAheadOfRamp) {
+  rampUp();
+
+  EXPECT_CALL(*pool_, onPoolReady(Ref(*clients_[2]), _))
+      .WillOnce(Invoke([](ActiveClient& client, AttachContext&) {
+        TestActiveClient::incrementActiveStreams(client);
+      }));
+  EXPECT_CALL(*pool_, instantiateActiveClient);
+  EXPECT_EQ(nullptr, pool_->newStreamImpl(context_, /*can_send_early_data=*/false));
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_adaptive_preconnect_.value());
+  pool_->destructAllConnections();
+}
+
+// Once demand shrinks, a connection beyond the recent peak is closed as it goes idle, while
+// those needed for the peak are kept.
+TEST_F(ConnPoolImplBaseAdaptivePreconnectTest, TrimsConnectionsBeyondPeakDemand) {
+  rampUp();
+
+  --clients_[0]->active_streams_;
+  pool_->onStreamClosed(*clients_[0], false);
+  EXPECT_EQ(ActiveClient::State::Closed, clients_[0]->state());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_adaptive_preconnect_trimmed_.value());
+
+  --clients_[1]->active_streams_;
+  pool_->onStreamClosed(*clients_[1], false);
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[1]->state());
+  EXPECT_EQ(ActiveClient::State::Ready, clients_[2]->state());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_adaptive_preconnect_trimmed_.value());
+  pool_->destructAllConnections();
+}
+
 TEST_F(ConnPoolImplBaseTest, PoolIdleCallbackTriggeredRemoteClose) {
   EXPECT_CALL(dispatcher_, createTimer_(_)).Times(AnyNumber());
 
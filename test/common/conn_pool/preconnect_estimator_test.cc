@@ -0,0 +1,108 @@
+#include <chrono>
+#include <deque>
+
+#include "source/common/conn_pool/preconnect_estimator.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace ConnectionPool {
+namespace {
+
+class PreconnectEstimatorTest : public testing::Test {
+public:
+  // Simulates streams arriving every interval and lasting for duration, from now on until end.
+  // Arrivals and completions at the same time are recorded completions first.
+  void simulateLoad(std::chrono::milliseconds interval, std::chrono::milliseconds duration,
+                    MonotonicTime end) {
+    for (; now_ < end; now_ += interval) {
+      while (!completions_.empty() && completions_.front() <= now_) {
+        completions_.pop_front();
+        estimator_.onDemand(now_, completions_.size());
+      }
+      completions_.push_back(now_ + duration);
+      estimator_.onDemand(now_, completions_.size());
+    }
+  }
+
+  PreconnectEstimator estimator_{std::chrono::milliseconds(10)};
+  MonotonicTime now_;
+  std::deque<MonotonicTime> completions_;
+};
+
+TEST_F(PreconnectEstimatorTest, NoSpareCapacityWithoutConnectLatency) {
+  simulateLoad(std::chrono::milliseconds(10), std::chrono::seconds(10),
+               now_ + std::chrono::seconds(1));
+  EXPECT_GT(estimator_.demandGrowthRate(now_), 0);
+  EXPECT_EQ(absl::nullopt, estimator_.connectLatency());
+  EXPECT_EQ(0U, estimator_.spareStreamCapacity(now_));
+}
+
+TEST_F(PreconnectEstimatorTest, NoSpareCapacityIfConnectionsAreFasterThanTarget) {
+  estimator_.onConnectLatency(std::chrono::milliseconds(5));
+  simulateLoad(std::chrono::milliseconds(10), std::chrono::seconds(10),
+               now_ + std::chrono::seconds(1));
+  EXPECT_EQ(0U, estimator_.spareStreamCapacity(now_));
+}
+
+TEST_F(PreconnectEstimatorTest, ConnectLatencyIsMovingAverage) {
+  estimator_.onConnectLatency(std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::milliseconds(100), estimator_.connectLatency());
+  estimator_.onConnectLatency(std::chrono::milliseconds(200));
+  EXPECT_EQ(std::chrono::milliseconds(120), estimator_.connectLatency());
+}
+
+// While streams ramp up at 100 per second, connections taking 40ms longer than the target to
+// establish need capacity for the 4 streams arriving in the meantime.
+TEST_F(PreconnectEstimatorTest, SpareCapacityCoversRamp) {
+  estimator_.onConnectLatency(std::chrono::milliseconds(50));
+  simulateLoad(std::chrono::milliseconds(10), std::chrono::seconds(60),
+               now_ + std::chrono::seconds(5));
+  EXPECT_NEAR(100, estimator_.demandGrowthRate(now_), 2);
+  EXPECT_EQ(4U, estimator_.spareStreamCapacity(now_));
+
+  // Faster connections need less spare capacity.
+  for (int i = 0; i < 50; ++i) {
+    estimator_.onConnectLatency(std::chrono::milliseconds(30));
+  }
+  EXPECT_EQ(2U, estimator_.spareStreamCapacity(now_));
+}
+
+// Once arrivals and completions balance, demand stops growing and the spare capacity is at most
+// the one stream rounding up leaves.
+TEST_F(PreconnectEstimatorTest, SpareCapacityFollowsSteadyState) {
+  estimator_.onConnectLatency(std::chrono::milliseconds(50));
+  // Streams lasting 500ms reach a steady state of 50 after 500ms.
+  simulateLoad(std::chrono::milliseconds(10), std::chrono::milliseconds(500),
+               now_ + std::chrono::milliseconds(400));
+  EXPECT_GT(estimator_.spareStreamCapacity(now_), 1U);
+
+  simulateLoad(std::chrono::milliseconds(10), std::chrono::milliseconds(500),
+               now_ + std::chrono::seconds(10));
+  EXPECT_EQ(50U, completions_.size());
+  EXPECT_NEAR(0, estimator_.demandGrowthRate(now_), 1);
+  EXPECT_LE(estimator_.spareStreamCapacity(now_), 1U);
+  EXPECT_EQ(50U, estimator_.peakDemand(now_));
+}
+
+// After a burst, the peak demand decays towards the current demand.
+TEST_F(PreconnectEstimatorTest, PeakDemandDecays) {
+  estimator_.onConnectLatency(std::chrono::milliseconds(50));
+  estimator_.onDemand(now_, 100);
+  estimator_.onDemand(now_, 10);
+  EXPECT_EQ(100U, estimator_.peakDemand(now_));
+  EXPECT_EQ(0U, estimator_.spareStreamCapacity(now_));
+  EXPECT_LT(estimator_.demandGrowthRate(now_), 0);
+
+  // 10 + 90 / e after one time constant, and 10 + 90 / e^6 after six.
+  EXPECT_EQ(44U, estimator_.peakDemand(now_ + PreconnectEstimator::PeakDecay));
+  EXPECT_EQ(11U, estimator_.peakDemand(now_ + 6 * PreconnectEstimator::PeakDecay));
+
+  // A new sample keeps the decayed peak.
+  estimator_.onDemand(now_ + PreconnectEstimator::PeakDecay, 10);
+  EXPECT_EQ(44U, estimator_.peakDemand(now_ + PreconnectEstimator::PeakDecay));
+}
+
+} // namespace
+} // namespace ConnectionPool
+} // namespace Envoy
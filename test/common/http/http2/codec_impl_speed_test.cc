@@ -0,0 +1,292 @@
+// Compares the HTTP/2 codec implementations -- nghttp2 called directly, nghttp2 behind the
+// http2::adapter wrapper, and oghttp2 -- on workloads that stress different parts of the codec:
+// many small streams, one large body, and large header blocks. A client and a server codec are
+// connected back to back through their mock connections, so the timings cover encoding, framing
+// and decoding on both sides, but no I/O.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/http/http2/codec_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/http/http2/codec_impl_test_util.h"
+#include "test/mocks/common.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+enum class Http2Impl {
+  Nghttp2,
+  WrappedNghttp2,
+  Oghttp2,
+};
+
+// The size of the slices the large body is built from, which is what a body read from a socket
+// typically looks like.
+constexpr uint64_t BodySliceSize = 16 * 1024;
+// Leaves room for the largest header-heavy case.
+constexpr uint32_t MaxHeadersCount = 1000;
+
+class Http2CodecSpeedTest {
+public:
+  explicit Http2CodecSpeedTest(Http2Impl http2_implementation) {
+    scoped_runtime_.mergeValues(
+        {{"envoy.reloadable_features.http2_new_codec_wrapper",
+          http2_implementation == Http2Impl::Nghttp2 ? "false" : "true"},
+         {"envoy.reloadable_features.http2_use_oghttp2",
+          http2_implementation == Http2Impl::Oghttp2 ? "true" : "false"}});
+
+    // Every stream of an iteration is encoded before either side dispatches, so the outbound
+    // frame limits must not mistake the benchmark for a flood.
+    http2_options_.mutable_max_outbound_frames()->set_value(100000000);
+    http2_options_.mutable_max_outbound_control_frames()->set_value(100000000);
+
+    client_ = std::make_unique<TestClientConnectionImpl>(
+        client_connection_, client_callbacks_, client_stats_store_, http2_options_, random_,
+        Http::DEFAULT_MAX_REQUEST_HEADERS_KB, MaxHeadersCount,
+        ProdNghttp2SessionFactory::get());
+    server_ = std::make_unique<TestServerConnectionImpl>(
+        server_connection_, server_callbacks_, server_stats_store_, http2_options_, random_,
+        Http::DEFAULT_MAX_REQUEST_HEADERS_KB, MaxHeadersCount,
+        envoy::config::core::v3::HttpProtocolOptions::ALLOW);
+
+    // Written frames are moved, not copied, into the peer's read buffer.
+    ON_CALL(client_connection_, write(_, _))
+        .WillByDefault(
+            Invoke([this](Buffer::Instance& data, bool) -> void { server_buffer_.move(data); }));
+    ON_CALL(server_connection_, write(_, _))
+        .WillByDefault(
+            Invoke([this](Buffer::Instance& data, bool) -> void { client_buffer_.move(data); }));
+    ON_CALL(server_connection_.dispatcher_, trackedObjectStackIsEmpty())
+        .WillByDefault(Return(true));
+    ON_CALL(server_callbacks_, newStream(_, _))
+        .WillByDefault(Invoke([this](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+          response_encoders_.push_back(&encoder);
+          return request_decoder_;
+        }));
+
+    // Exchange the connection prefaces and SETTINGS.
+    drive();
+  }
+
+  ~Http2CodecSpeedTest() {
+    // Destroy the codecs before the connections they point at.
+    client_.reset();
+    server_.reset();
+  }
+
+  // Sends num_streams header-only requests, each answered with a small body.
+  void manyStreams(::benchmark::State& state, uint64_t num_streams) {
+    TestRequestHeaderMapImpl request_headers = requestHeaders(0);
+    TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      for (uint64_t i = 0; i < num_streams; ++i) {
+        RequestEncoder& request_encoder = client_->newStream(response_decoder_);
+        RELEASE_ASSERT(request_encoder.encodeHeaders(request_headers, true).ok(), "");
+      }
+      drive();
+      for (ResponseEncoder* encoder : response_encoders_) {
+        encoder->encodeHeaders(response_headers, false);
+        Buffer::OwnedImpl body("hello");
+        encoder->encodeData(body, true);
+      }
+      drive();
+      finishIteration();
+    }
+  }
+
+  // Uploads one body of body_size bytes, the way a proxied upload arrives from the downstream.
+  void largeBody(::benchmark::State& state, uint64_t body_size) {
+    TestRequestHeaderMapImpl request_headers = requestHeaders(0);
+    request_headers.setMethod("POST");
+    TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    const std::string slice(BodySliceSize, 'a');
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      state.PauseTiming();
+      Buffer::OwnedImpl body;
+      for (uint64_t size = 0; size < body_size; size += slice.size()) {
+        body.appendSliceForTest(slice);
+      }
+      state.ResumeTiming();
+
+      RequestEncoder& request_encoder = client_->newStream(response_decoder_);
+      RELEASE_ASSERT(request_encoder.encodeHeaders(request_headers, false).ok(), "");
+      request_encoder.encodeData(body, true);
+      drive();
+      RELEASE_ASSERT(response_encoders_.size() == 1, "");
+      response_encoders_.front()->encodeHeaders(response_headers, true);
+      drive();
+      finishIteration();
+    }
+    state.SetBytesProcessed(state.iterations() * body_size);
+  }
+
+  // Sends num_streams requests and responses, each carrying num_headers custom headers.
+  void headerHeavy(::benchmark::State& state, uint64_t num_streams, uint64_t num_headers) {
+    TestRequestHeaderMapImpl request_headers = requestHeaders(num_headers);
+    TestResponseHeaderMapImpl response_headers{{":status", "200"}};
+    for (uint64_t i = 0; i < num_headers; ++i) {
+      response_headers.addCopy(absl::StrCat("x-response-header-", i),
+                               absl::StrCat("response-value-", i, "-", std::string(40, 'v')));
+    }
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      for (uint64_t i = 0; i < num_streams; ++i) {
+        RequestEncoder& request_encoder = client_->newStream(response_decoder_);
+        RELEASE_ASSERT(request_encoder.encodeHeaders(request_headers, true).ok(), "");
+      }
+      drive();
+      for (ResponseEncoder* encoder : response_encoders_) {
+        encoder->encodeHeaders(response_headers, true);
+      }
+      drive();
+      finishIteration();
+    }
+  }
+
+private:
+  static TestRequestHeaderMapImpl requestHeaders(uint64_t num_headers) {
+    TestRequestHeaderMapImpl request_headers{
+        {":method", "GET"}, {":path", "/"}, {":scheme", "http"}, {":authority", "host"}};
+    for (uint64_t i = 0; i < num_headers; ++i) {
+      request_headers.addCopy(absl::StrCat("x-request-header-", i),
+                              absl::StrCat("request-value-", i, "-", std::string(40, 'v')));
+    }
+    return request_headers;
+  }
+
+  // Dispatches on both sides until neither has anything left to read or write.
+  void drive() {
+    while (server_buffer_.length() > 0 || client_buffer_.length() > 0 ||
+           client_->wantsToWrite() || server_->wantsToWrite()) {
+      if (server_buffer_.length() > 0 || server_->wantsToWrite()) {
+        RELEASE_ASSERT(server_->dispatch(server_buffer_).ok(), "");
+      }
+      if (client_buffer_.length() > 0 || client_->wantsToWrite()) {
+        RELEASE_ASSERT(client_->dispatch(client_buffer_).ok(), "");
+      }
+    }
+  }
+
+  // Frees the streams closed during the iteration.
+  void finishIteration() {
+    response_encoders_.clear();
+    client_connection_.dispatcher_.clearDeferredDeleteList();
+    server_connection_.dispatcher_.clearDeferredDeleteList();
+  }
+
+  TestScopedRuntime scoped_runtime_;
+  envoy::config::core::v3::Http2ProtocolOptions http2_options_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  Stats::IsolatedStoreImpl client_stats_store_;
+  Stats::IsolatedStoreImpl server_stats_store_;
+  NiceMock<Network::MockConnection> client_connection_;
+  NiceMock<Network::MockConnection> server_connection_;
+  NiceMock<MockConnectionCallbacks> client_callbacks_;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks_;
+  NiceMock<MockRequestDecoder> request_decoder_;
+  NiceMock<MockResponseDecoder> response_decoder_;
+  std::unique_ptr<TestClientConnectionImpl> client_;
+  std::unique_ptr<TestServerConnectionImpl> server_;
+  Buffer::OwnedImpl client_buffer_;
+  Buffer::OwnedImpl server_buffer_;
+  std::vector<ResponseEncoder*> response_encoders_;
+};
+
+void manyStreams(::benchmark::State& state, Http2Impl http2_implementation) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 10) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Http2CodecSpeedTest speed_test(http2_implementation);
+  speed_test.manyStreams(state, state.range(0));
+}
+
+void largeBody(::benchmark::State& state, Http2Impl http2_implementation) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 64 * 1024) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Http2CodecSpeedTest speed_test(http2_implementation);
+  speed_test.largeBody(state, state.range(0));
+}
+
+void headerHeavy(::benchmark::State& state, Http2Impl http2_implementation) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 10) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Http2CodecSpeedTest speed_test(http2_implementation);
+  speed_test.headerHeavy(state, 100, state.range(0));
+}
+
+BENCHMARK_CAPTURE(manyStreams, nghttp2, Http2Impl::Nghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000);
+BENCHMARK_CAPTURE(manyStreams, wrappedNghttp2, Http2Impl::WrappedNghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000);
+BENCHMARK_CAPTURE(manyStreams, oghttp2, Http2Impl::Oghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000);
+
+BENCHMARK_CAPTURE(largeBody, nghttp2, Http2Impl::Nghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(16)
+    ->Range(64 * 1024, 16 * 1024 * 1024);
+BENCHMARK_CAPTURE(largeBody, wrappedNghttp2, Http2Impl::WrappedNghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(16)
+    ->Range(64 * 1024, 16 * 1024 * 1024);
+BENCHMARK_CAPTURE(largeBody, oghttp2, Http2Impl::Oghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(16)
+    ->Range(64 * 1024, 16 * 1024 * 1024);
+
+BENCHMARK_CAPTURE(headerHeavy, nghttp2, Http2Impl::Nghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 100);
+BENCHMARK_CAPTURE(headerHeavy, wrappedNghttp2, Http2Impl::WrappedNghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 100);
+BENCHMARK_CAPTURE(headerHeavy, oghttp2, Http2Impl::Oghttp2)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(10, 100);
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
@@ -1013,6 +1013,54 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   driveToCompletion();
 }
 
+// A DATA frame that would end partway through a slice of the body is shortened to end on the
+// slice boundary, so that the payload is moved rather than copied into the output buffer.
+TEST_P(Http2CodecImplTest, DataFramesAlignedToSlices) {
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  driveToCompletion();
+
+  std::vector<uint64_t> frame_sizes;
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .WillRepeatedly(Invoke([&frame_sizes](Buffer::Instance& data, bool) {
+        frame_sizes.push_back(data.length());
+      }));
+  Buffer::OwnedImpl body;
+  body.appendSliceForTest(std::string(10000, 'a'));
+  body.appendSliceForTest(std::string(10000, 'b'));
+  request_encoder_->encodeData(body, true);
+  driveToCompletion();
+  EXPECT_EQ((std::vector<uint64_t>{10000, 10000}), frame_sizes);
+}
+
+TEST_P(Http2CodecImplTest, DataFramesNotAlignedToSlicesWhenDisabled) {
+  scoped_runtime_.mergeValues(
+      {{"envoy.reloadable_features.http2_align_data_frames_to_slices", "false"}});
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  driveToCompletion();
+
+  std::vector<uint64_t> frame_sizes;
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .WillRepeatedly(Invoke([&frame_sizes](Buffer::Instance& data, bool) {
+        frame_sizes.push_back(data.length());
+      }));
+  Buffer::OwnedImpl body;
+  body.appendSliceForTest(std::string(10000, 'a'));
+  body.appendSliceForTest(std::string(10000, 'b'));
+  request_encoder_->encodeData(body, true);
+  driveToCompletion();
+  EXPECT_EQ((std::vector<uint64_t>{16384, 3616}), frame_sizes);
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
@@ -100,6 +100,45 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
 
+TEST(IoSocketHandleImpl, SendmmsgSendsAllMessagesWithSharedPacketInfo) {
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+
+  std::string first = "hello";
+  std::string second = "world!";
+  RawSliceArrays slices(2, absl::FixedArray<Buffer::RawSlice>(2));
+  slices[0][0] = {first.data(), first.size()};
+  // Empty slices are skipped.
+  slices[0][1] = {nullptr, 0};
+  slices[1][0] = {second.data(), 3};
+  slices[1][1] = {second.data() + 3, 3};
+  Address::Ipv4Instance peer_address("127.0.0.2", 1234);
+  Address::Ipv4Instance self_address("127.0.0.1");
+
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, 0))
+      .WillOnce(Invoke([&](os_fd_t, struct mmsghdr* msgvec, unsigned int vlen,
+                           int) -> Api::SysCallIntResult {
+        for (unsigned int i = 0; i < vlen; ++i) {
+          const msghdr& message = msgvec[i].msg_hdr;
+          EXPECT_EQ(peer_address.sockAddr(), message.msg_name);
+          EXPECT_EQ(peer_address.sockAddrLen(), message.msg_namelen);
+          EXPECT_NE(nullptr, message.msg_control);
+          EXPECT_EQ(msgvec[0].msg_hdr.msg_control, message.msg_control);
+        }
+        EXPECT_EQ(1U, msgvec[0].msg_hdr.msg_iovlen);
+        EXPECT_EQ(first.size(), msgvec[0].msg_hdr.msg_iov[0].iov_len);
+        EXPECT_EQ(2U, msgvec[1].msg_hdr.msg_iovlen);
+        EXPECT_EQ(second.data() + 3, msgvec[1].msg_hdr.msg_iov[1].iov_base);
+        return {1, 0};
+      }));
+
+  IoSocketHandleImpl io_handle;
+  Api::IoCallUint64Result result = io_handle.sendmmsg(slices, 0, self_address.ip(), peer_address);
+  ASSERT_TRUE(result.ok());
+  // Only the number of messages sent is reported.
+  EXPECT_EQ(1U, result.return_value_);
+}
+
 TEST(IoSocketHandleImpl, InterfaceNameWithPipe) {
   std::string path = TestEnvironment::unixDomainSocketPath("foo.sock");
 
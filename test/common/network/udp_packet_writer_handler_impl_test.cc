@@ -0,0 +1,191 @@
+#include <string>
+#include <vector>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_socket_error_impl.h"
+#include "source/common/network/udp_packet_writer_handler_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/io_handle.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+Api::IoCallUint64Result makeNoError(uint64_t rc) {
+  auto no_error = Api::ioCallUint64ResultNoError();
+  no_error.return_value_ = rc;
+  return no_error;
+}
+
+Api::IoCallUint64Result makeError(int sys_errno) {
+  return Api::IoCallUint64Result(0, Api::IoErrorPtr(new IoSocketError(sys_errno),
+                                                    IoSocketError::deleteIoError));
+}
+
+std::vector<std::string> toStrings(const RawSliceArrays& slices) {
+  std::vector<std::string> packets;
+  for (const auto& packet : slices) {
+    packets.emplace_back(static_cast<const char*>(packet[0].mem_), packet[0].len_);
+  }
+  return packets;
+}
+
+class UdpMmsgBatchWriterTest : public testing::Test {
+public:
+  UdpMmsgBatchWriterTest() { ON_CALL(io_handle_, supportsMmsg()).WillByDefault(Return(true)); }
+
+  Api::IoCallUint64Result write(const std::string& packet, const Address::Instance& peer_address,
+                                const Address::Ip* local_ip = nullptr) {
+    Buffer::OwnedImpl buffer(packet);
+    return writer_.writePacket(buffer, local_ip, peer_address);
+  }
+
+  NiceMock<MockIoHandle> io_handle_;
+  UdpMmsgBatchWriter writer_{io_handle_, 3};
+  Address::Ipv4Instance peer_address_{"10.0.0.1", 1000};
+  Address::Ipv4Instance other_peer_address_{"10.0.0.2", 1000};
+};
+
+TEST_F(UdpMmsgBatchWriterTest, QueuesUntilFlushed) {
+  EXPECT_TRUE(writer_.isBatchMode());
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _)).Times(0);
+  EXPECT_EQ(5U, write("hello", peer_address_).return_value_);
+  EXPECT_EQ(5U, write("world", peer_address_).return_value_);
+  EXPECT_EQ(2U, writer_.queuedPackets());
+
+  EXPECT_CALL(io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Invoke([&](const RawSliceArrays& slices, int, const Address::Ip*,
+                           const Address::Instance& peer_address) {
+        EXPECT_EQ(std::vector<std::string>({"hello", "world"}), toStrings(slices));
+        EXPECT_EQ(peer_address_, peer_address);
+        return makeNoError(2);
+      }));
+  Api::IoCallUint64Result result = writer_.flush();
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(10U, result.return_value_);
+  EXPECT_EQ(0U, writer_.queuedPackets());
+
+  // Flushing an empty queue is a no-op.
+  EXPECT_TRUE(writer_.flush().ok());
+}
+
+TEST_F(UdpMmsgBatchWriterTest, FlushesWhenFull) {
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _))
+      .WillOnce(Invoke([](const RawSliceArrays& slices, int, const Address::Ip*,
+                          const Address::Instance&) {
+        EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), toStrings(slices));
+        return makeNoError(3);
+      }));
+  write("a", peer_address_);
+  write("b", peer_address_);
+  EXPECT_EQ(1U, write("c", peer_address_).return_value_);
+  EXPECT_EQ(0U, writer_.queuedPackets());
+}
+
+TEST_F(UdpMmsgBatchWriterTest, FlushesOnDestinationChange) {
+  Address::Ipv4Instance local_address("10.0.0.3");
+  testing::InSequence s;
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, nullptr, _))
+      .WillOnce(Invoke([&](const RawSliceArrays& slices, int, const Address::Ip*,
+                           const Address::Instance& peer_address) {
+        EXPECT_EQ(std::vector<std::string>({"a", "b"}), toStrings(slices));
+        EXPECT_EQ(peer_address_, peer_address);
+        return makeNoError(2);
+      }));
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, nullptr, _))
+      .WillOnce(Invoke([&](const RawSliceArrays& slices, int, const Address::Ip*,
+                           const Address::Instance& peer_address) {
+        EXPECT_EQ(std::vector<std::string>({"c"}), toStrings(slices));
+        EXPECT_EQ(other_peer_address_, peer_address);
+        return makeNoError(1);
+      }));
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _))
+      .WillOnce(Invoke([&](const RawSliceArrays& slices, int, const Address::Ip* local_ip,
+                           const Address::Instance&) {
+        EXPECT_EQ(std::vector<std::string>({"d"}), toStrings(slices));
+        EXPECT_EQ("10.0.0.3", local_ip->addressAsString());
+        return makeNoError(1);
+      }));
+
+  write("a", peer_address_);
+  write("b", peer_address_);
+  write("c", other_peer_address_);
+  write("d", other_peer_address_, local_address.ip());
+  EXPECT_EQ(1U, writer_.queuedPackets());
+  writer_.flush();
+}
+
+TEST_F(UdpMmsgBatchWriterTest, ResendsRemainderOfPartialBatch) {
+  testing::InSequence s;
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _)).WillOnce(Return(ByMove(makeNoError(1))));
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _)).WillOnce(Return(ByMove(makeError(EINTR))));
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _))
+      .WillOnce(Invoke([](const RawSliceArrays& slices, int, const Address::Ip*,
+                          const Address::Instance&) {
+        EXPECT_EQ(std::vector<std::string>({"bb"}), toStrings(slices));
+        return makeNoError(1);
+      }));
+  write("a", peer_address_);
+  write("bb", peer_address_);
+  Api::IoCallUint64Result result = writer_.flush();
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(3U, result.return_value_);
+}
+
+TEST_F(UdpMmsgBatchWriterTest, BlocksAndDropsOnAgain) {
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                             IoSocketError::deleteIoError)))));
+  write("a", peer_address_);
+  write("b", peer_address_);
+  Api::IoCallUint64Result result = writer_.flush();
+  ASSERT_FALSE(result.ok());
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_TRUE(writer_.isWriteBlocked());
+  EXPECT_EQ(0U, writer_.queuedPackets());
+
+  writer_.setWritable();
+  EXPECT_FALSE(writer_.isWriteBlocked());
+}
+
+TEST_F(UdpMmsgBatchWriterTest, SendsOneAtATimeWithoutMmsg) {
+  EXPECT_CALL(io_handle_, supportsMmsg()).WillRepeatedly(Return(false));
+  EXPECT_CALL(io_handle_, sendmmsg(_, _, _, _)).Times(0);
+  std::vector<std::string> sent;
+  EXPECT_CALL(io_handle_, sendmsg(_, 1, 0, nullptr, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](const Buffer::RawSlice* slices, uint64_t, int,
+                                 const Address::Ip*, const Address::Instance&) {
+        sent.emplace_back(static_cast<const char*>(slices[0].mem_), slices[0].len_);
+        return makeNoError(slices[0].len_);
+      }));
+  write("a", peer_address_);
+  write("bb", peer_address_);
+  Api::IoCallUint64Result result = writer_.flush();
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(3U, result.return_value_);
+  EXPECT_EQ(std::vector<std::string>({"a", "bb"}), sent);
+}
+
+TEST(UdpMmsgBatchWriterFactoryTest, CreatesBatchWriter) {
+  NiceMock<MockIoHandle> io_handle;
+  Stats::IsolatedStoreImpl scope;
+  UdpMmsgBatchWriterFactory factory;
+  EXPECT_TRUE(factory.createUdpPacketWriter(io_handle, scope)->isBatchMode());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,179 @@
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/common/base64.h"
+#include "source/common/protobuf/deterministic_hash.h"
+#include "source/common/protobuf/utility.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace DeterministicProtoHash {
+namespace {
+
+TEST(DeterministicProtoHashTest, EqualMessagesHashEqually) {
+  envoy::config::cluster::v3::Cluster a;
+  a.set_name("cluster");
+  a.mutable_connect_timeout()->set_seconds(5);
+  envoy::config::cluster::v3::Cluster b = a;
+  EXPECT_EQ(hash(a), hash(b));
+
+  b.mutable_connect_timeout()->set_seconds(6);
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, EmptyAndUnsetSubMessagesDiffer) {
+  envoy::config::cluster::v3::Cluster unset;
+  envoy::config::cluster::v3::Cluster empty;
+  empty.mutable_connect_timeout();
+  EXPECT_NE(hash(unset), hash(empty));
+}
+
+TEST(DeterministicProtoHashTest, RepeatedFieldOrderMatters) {
+  ProtobufWkt::ListValue a;
+  a.add_values()->set_string_value("ab");
+  a.add_values()->set_string_value("c");
+  ProtobufWkt::ListValue b;
+  b.add_values()->set_string_value("c");
+  b.add_values()->set_string_value("ab");
+  ProtobufWkt::ListValue c;
+  c.add_values()->set_string_value("a");
+  c.add_values()->set_string_value("bc");
+  EXPECT_NE(hash(a), hash(b));
+  EXPECT_NE(hash(a), hash(c));
+}
+
+TEST(DeterministicProtoHashTest, MapOrderIgnored) {
+  ProtobufWkt::Struct a;
+  (*a.mutable_fields())["ab"].set_string_value("fgh");
+  (*a.mutable_fields())["cde"].set_string_value("ij");
+  ProtobufWkt::Struct b;
+  (*b.mutable_fields())["cde"].set_string_value("ij");
+  (*b.mutable_fields())["ab"].set_string_value("fgh");
+  EXPECT_EQ(hash(a), hash(b));
+
+  (*b.mutable_fields())["cde"].set_string_value("ik");
+  EXPECT_NE(hash(a), hash(b));
+}
+
+// Any is hashed by its unpacked contents, so packings that differ only in map order hash equally.
+TEST(DeterministicProtoHashTest, AnyHashedByContents) {
+  ProtobufWkt::Struct s;
+  (*s.mutable_fields())["ab"].set_string_value("fgh");
+  (*s.mutable_fields())["cde"].set_string_value("ij");
+  ProtobufWkt::Any a1;
+  a1.PackFrom(s);
+  ProtobufWkt::Any a2 = a1;
+  a2.set_value(Base64::decode("CgsKA2NkZRIEGgJpagoLCgJhYhIFGgNmZ2g="));
+  ProtobufWkt::Any a3 = a1;
+  a3.set_value(Base64::decode("CgsKAmFiEgUaA2ZnaAoLCgNjZGUSBBoCaWo="));
+  EXPECT_NE(a2.value(), a3.value());
+  EXPECT_EQ(hash(a1), hash(a2));
+  EXPECT_EQ(hash(a2), hash(a3));
+
+  // The type is part of the hash, even for identical contents.
+  ProtobufWkt::Any other_type = a1;
+  other_type.set_type_url("type.googleapis.com/google.protobuf.Value");
+  EXPECT_NE(hash(a1), hash(other_type));
+}
+
+TEST(DeterministicProtoHashTest, AnyOfUnknownTypeHashedByBytes) {
+  ProtobufWkt::Any a;
+  a.set_type_url("type.googleapis.com/not.a.Type");
+  a.set_value("abc");
+  ProtobufWkt::Any b = a;
+  EXPECT_EQ(hash(a), hash(b));
+  b.set_value("abd");
+  EXPECT_NE(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, UnknownFieldsIgnored) {
+  ProtobufWkt::Value a;
+  a.set_string_value("abc");
+  ProtobufWkt::Value b = a;
+  // Field 100 with varint 1.
+  b.GetReflection()->MutableUnknownFields(&b)->AddVarint(100, 1);
+  EXPECT_EQ(hash(a), hash(b));
+}
+
+TEST(DeterministicProtoHashTest, Seed) {
+  ProtobufWkt::Value value;
+  value.set_number_value(1);
+  EXPECT_NE(hash(value, 0), hash(value, 1));
+  EXPECT_EQ(hash(value, 1), hash(value, 1));
+}
+
+// For change detection the hash must tell messages apart exactly when the TextFormat based hash,
+// which it replaced, does.
+TEST(DeterministicProtoHashTest, AgreesWithTextFormatHash) {
+  std::vector<envoy::config::cluster::v3::Cluster> clusters;
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+lb_policy: ROUND_ROBIN
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 2s
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+lb_policy: RING_HASH
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+metadata:
+  filter_metadata:
+    x:
+      a: 1
+      b: 2
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+metadata:
+  filter_metadata:
+    x:
+      b: 2
+      a: 1
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+transport_socket:
+  name: envoy.transport_sockets.tls
+  typed_config:
+    "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.UpstreamTlsContext
+    sni: example.com
+)EOF"));
+  clusters.push_back(TestUtility::parseYaml<envoy::config::cluster::v3::Cluster>(R"EOF(
+name: a
+connect_timeout: 1s
+transport_socket:
+  name: envoy.transport_sockets.tls
+  typed_config:
+    "@type": type.googleapis.com/envoy.extensions.transport_sockets.tls.v3.UpstreamTlsContext
+    sni: example.org
+)EOF"));
+
+  for (const auto& a : clusters) {
+    for (const auto& b : clusters) {
+      EXPECT_EQ(MessageUtil::textFormatHash(a) == MessageUtil::textFormatHash(b),
+                hash(a) == hash(b))
+          << a.DebugString() << " vs " << b.DebugString();
+    }
+  }
+}
+
+} // namespace
+} // namespace DeterministicProtoHash
+} // namespace Envoy
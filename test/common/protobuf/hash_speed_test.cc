@@ -0,0 +1,83 @@
+// Compares MessageUtil::hash(), which walks the message with reflection, against the TextFormat
+// based MessageUtil::textFormatHash() it replaced, on what CDS hashes on every push: a set of
+// clusters, each with an upstream TLS context packed in an Any.
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+
+#include "source/common/protobuf/utility.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+std::vector<envoy::config::cluster::v3::Cluster> makeClusters(uint64_t num_clusters) {
+  std::vector<envoy::config::cluster::v3::Cluster> clusters(num_clusters);
+  for (uint64_t i = 0; i < num_clusters; ++i) {
+    envoy::config::cluster::v3::Cluster& cluster = clusters[i];
+    cluster.set_name(absl::StrCat("cluster_", i));
+    cluster.set_type(envoy::config::cluster::v3::Cluster::EDS);
+    cluster.mutable_connect_timeout()->set_seconds(5);
+    cluster.mutable_eds_cluster_config()->set_service_name(absl::StrCat("service_", i));
+    cluster.mutable_eds_cluster_config()->mutable_eds_config()->mutable_ads();
+    (*cluster.mutable_metadata()->mutable_filter_metadata())["envoy.lb"]
+        .mutable_fields()
+        ->insert({"canary", ValueUtil::boolValue(i % 10 == 0)});
+
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+    tls_context.set_sni(absl::StrCat("service-", i, ".example.com"));
+    auto* common_tls_context = tls_context.mutable_common_tls_context();
+    common_tls_context->mutable_tls_params()->add_cipher_suites("ECDHE-ECDSA-AES128-GCM-SHA256");
+    common_tls_context->mutable_tls_params()->add_cipher_suites("ECDHE-RSA-AES128-GCM-SHA256");
+    common_tls_context->add_alpn_protocols("h2");
+    common_tls_context->add_alpn_protocols("http/1.1");
+    auto* certificate = common_tls_context->add_tls_certificates();
+    certificate->mutable_certificate_chain()->set_inline_string(std::string(2048, 'c'));
+    certificate->mutable_private_key()->set_inline_string(std::string(1024, 'k'));
+    auto* validation_context = common_tls_context->mutable_validation_context();
+    validation_context->mutable_trusted_ca()->set_inline_string(std::string(4096, 'a'));
+    validation_context->add_match_typed_subject_alt_names()->mutable_matcher()->set_exact(
+        absl::StrCat("spiffe://cluster.local/ns/default/sa/service-", i));
+    cluster.mutable_transport_socket()->set_name("envoy.transport_sockets.tls");
+    cluster.mutable_transport_socket()->mutable_typed_config()->PackFrom(tls_context);
+  }
+  return clusters;
+}
+
+void hashClusters(::benchmark::State& state, bool text_format) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  const std::vector<envoy::config::cluster::v3::Cluster> clusters = makeClusters(state.range(0));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (const auto& cluster : clusters) {
+      ::benchmark::DoNotOptimize(text_format ? MessageUtil::textFormatHash(cluster)
+                                             : MessageUtil::hash(cluster));
+    }
+  }
+}
+
+BENCHMARK_CAPTURE(hashClusters, reflection, false)
+    ->Unit(::benchmark::kMillisecond)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Arg(50000);
+BENCHMARK_CAPTURE(hashClusters, textFormat, true)
+    ->Unit(::benchmark::kMillisecond)
+    ->Arg(100)
+    ->Arg(10000)
+    ->Arg(50000);
+
+} // namespace
+} // namespace Envoy
@@ -194,6 +194,10 @@ TEST_F(ProtobufUtilityTest, MessageUtilHash) {
   EXPECT_EQ(MessageUtil::hash(a2), MessageUtil::hash(a3));
   EXPECT_NE(0, MessageUtil::hash(a1));
   EXPECT_NE(MessageUtil::hash(s), MessageUtil::hash(a1));
+
+  EXPECT_EQ(MessageUtil::textFormatHash(a1), MessageUtil::textFormatHash(a2));
+  EXPECT_EQ(MessageUtil::textFormatHash(a2), MessageUtil::textFormatHash(a3));
+  EXPECT_NE(MessageUtil::textFormatHash(s), MessageUtil::textFormatHash(a1));
 }
 
 TEST_F(ProtobufUtilityTest, RepeatedPtrUtilDebugString) {
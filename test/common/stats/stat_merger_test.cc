@@ -103,6 +103,26 @@ TEST_F(StatMergerTest, BasicDefaultAccumulationImport) {
   EXPECT_EQ(789, whywassixafraidofseven_.value());
 }
 
+TEST_F(StatMergerTest, SnapshotMerge) {
+  store_.counterFromString("draculaer").inc();
+  EXPECT_EQ(1, store_.counterFromString("draculaer").latch());
+
+  StatNamePool pool(store_.symbolTable());
+  StatNameDynamicPool dynamic_pool(store_.symbolTable());
+  StatSnapshotBuilder snapshot(store_.symbolTable());
+  snapshot.addCounter(pool.add("draculaer"), 2);
+  snapshot.addCounter(dynamic_pool.add("dynamic.counter"), 5);
+  snapshot.addGauge(pool.add("whywassixafraidofseven"), 111);
+  EXPECT_TRUE(stat_merger_.mergeSnapshot(snapshot.serialize()));
+
+  EXPECT_EQ(3, store_.counterFromString("draculaer").value());
+  EXPECT_EQ(2, store_.counterFromString("draculaer").latch());
+  EXPECT_EQ(5, store_.counterFromStatName(dynamic_pool.add("dynamic.counter")).value());
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+
+  EXPECT_FALSE(stat_merger_.mergeSnapshot("not a snapshot"));
+}
+
 TEST_F(StatMergerTest, MultipleImportsWithAccumulationLogic) {
   {
     Protobuf::Map<std::string, uint64_t> gauges;
@@ -0,0 +1,178 @@
+#include <string>
+#include <vector>
+
+#include "source/common/stats/stat_snapshot.h"
+#include "source/common/stats/symbol_table.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+// Builds snapshots in one symbol table and decodes them into another, as happens across a hot
+// restart.
+class StatSnapshotTest : public testing::Test {
+protected:
+  StatSnapshotTest()
+      : parent_symbolic_pool_(parent_symbol_table_), parent_dynamic_pool_(parent_symbol_table_),
+        child_symbolic_pool_(child_symbol_table_), child_dynamic_pool_(child_symbol_table_) {}
+
+  // Encodes a name using "D:" to mark dynamic segments, and "," for dots within a dynamic
+  // segment. Runs of symbolic segments are encoded together so that empty segments survive.
+  StatName makeStatName(absl::string_view descriptor, SymbolTable& symbol_table,
+                        StatNamePool& symbolic_pool, StatNameDynamicPool& dynamic_pool,
+                        std::vector<SymbolTable::StoragePtr>& storage) {
+    StatNameVec components;
+    std::vector<absl::string_view> symbolic_run;
+    auto flush_symbolic_run = [&]() {
+      if (!symbolic_run.empty()) {
+        components.push_back(symbolic_pool.add(absl::StrJoin(symbolic_run, ".")));
+        symbolic_run.clear();
+      }
+    };
+    for (absl::string_view segment : absl::StrSplit(descriptor, '.')) {
+      if (absl::StartsWith(segment, "D:")) {
+        flush_symbolic_run();
+        components.push_back(
+            dynamic_pool.add(absl::StrReplaceAll(segment.substr(2), {{",", "."}})));
+      } else {
+        symbolic_run.push_back(segment);
+      }
+    }
+    flush_symbolic_run();
+    storage.push_back(symbol_table.join(components));
+    return StatName(storage.back().get());
+  }
+
+  StatName parentStatName(absl::string_view descriptor) {
+    return makeStatName(descriptor, parent_symbol_table_, parent_symbolic_pool_,
+                        parent_dynamic_pool_, parent_storage_);
+  }
+
+  StatName childStatName(absl::string_view descriptor) {
+    return makeStatName(descriptor, child_symbol_table_, child_symbolic_pool_,
+                        child_dynamic_pool_, child_storage_);
+  }
+
+  using DecodedStats = std::vector<std::pair<std::string, uint64_t>>;
+
+  // Decodes the snapshot, recording each stat by name along with a check that the decoded
+  // StatName is exactly the one the child itself would have built.
+  bool decode(absl::string_view snapshot, const std::vector<std::string>& counter_descriptors,
+              const std::vector<std::string>& gauge_descriptors) {
+    size_t counter_index = 0;
+    size_t gauge_index = 0;
+    auto check = [this](const std::vector<std::string>& descriptors, size_t& index,
+                        DecodedStats& out) {
+      return [this, &descriptors, &index, &out](StatName stat_name, uint64_t value) {
+        ASSERT_LT(index, descriptors.size());
+        EXPECT_EQ(childStatName(descriptors[index]), stat_name) << descriptors[index];
+        out.emplace_back(child_symbol_table_.toString(stat_name), value);
+        ++index;
+      };
+    };
+    return StatSnapshotDecoder::decode(snapshot, child_symbol_table_,
+                                       check(counter_descriptors, counter_index, counters_),
+                                       check(gauge_descriptors, gauge_index, gauges_));
+  }
+
+  SymbolTableImpl parent_symbol_table_;
+  StatNamePool parent_symbolic_pool_;
+  StatNameDynamicPool parent_dynamic_pool_;
+  std::vector<SymbolTable::StoragePtr> parent_storage_;
+
+  SymbolTableImpl child_symbol_table_;
+  StatNamePool child_symbolic_pool_;
+  StatNameDynamicPool child_dynamic_pool_;
+  std::vector<SymbolTable::StoragePtr> child_storage_;
+
+  DecodedStats counters_;
+  DecodedStats gauges_;
+};
+
+TEST_F(StatSnapshotTest, RoundTrip) {
+  const std::vector<std::string> counters = {
+      "cluster.a.upstream_rq_total", "cluster.b.upstream_rq_total", "D:dynamic.counter",
+      "one.D:two.three.D:four,five.six", "hello..world", "D:hello.x..D:world"};
+  const std::vector<std::string> gauges = {"cluster.a.membership_total", "D:dynamic.gauge"};
+
+  StatSnapshotBuilder builder(parent_symbol_table_);
+  uint64_t value = 0;
+  for (const std::string& counter : counters) {
+    builder.addCounter(parentStatName(counter), ++value);
+  }
+  for (const std::string& gauge : gauges) {
+    builder.addGauge(parentStatName(gauge), ++value);
+  }
+  EXPECT_EQ(counters.size(), builder.numCounters());
+  EXPECT_EQ(gauges.size(), builder.numGauges());
+
+  const std::string snapshot = builder.serialize();
+  EXPECT_EQ(builder.byteSize(), snapshot.size());
+  ASSERT_TRUE(decode(snapshot, counters, gauges));
+
+  EXPECT_EQ((DecodedStats{{"cluster.a.upstream_rq_total", 1},
+                          {"cluster.b.upstream_rq_total", 2},
+                          {"dynamic.counter", 3},
+                          {"one.two.three.four.five.six", 4},
+                          {"hello..world", 5},
+                          {"hello.x..world", 6}}),
+            counters_);
+  EXPECT_EQ((DecodedStats{{"cluster.a.membership_total", 7}, {"dynamic.gauge", 8}}), gauges_);
+}
+
+// Tokens shared between stats are stored once, so the snapshot grows much more slowly than the
+// total length of the names it holds.
+TEST_F(StatSnapshotTest, SharedTokensStoredOnce) {
+  StatSnapshotBuilder builder(parent_symbol_table_);
+  uint64_t names_size = 0;
+  for (uint32_t i = 0; i < 100; ++i) {
+    const std::string name = absl::StrCat("cluster.service_", i % 10, ".upstream_rq_", i / 10);
+    builder.addCounter(parentStatName(name), i);
+    names_size += name.size();
+  }
+  EXPECT_LT(builder.byteSize() * 3, names_size);
+}
+
+TEST_F(StatSnapshotTest, Empty) {
+  StatSnapshotBuilder builder(parent_symbol_table_);
+  EXPECT_TRUE(decode(builder.serialize(), {}, {}));
+  EXPECT_TRUE(counters_.empty());
+  EXPECT_TRUE(gauges_.empty());
+}
+
+TEST_F(StatSnapshotTest, Malformed) {
+  StatSnapshotBuilder builder(parent_symbol_table_);
+  builder.addCounter(parentStatName("a.b.c"), 1);
+  builder.addGauge(parentStatName("a.D:b"), 2);
+  const std::string snapshot = builder.serialize();
+
+  // Every truncation is rejected.
+  for (size_t size = 0; size < snapshot.size(); ++size) {
+    EXPECT_FALSE(StatSnapshotDecoder::decode(
+        absl::string_view(snapshot).substr(0, size), child_symbol_table_,
+        [](StatName, uint64_t) {}, [](StatName, uint64_t) {}))
+        << size;
+  }
+
+  // So are trailing bytes, and a bad magic number.
+  EXPECT_FALSE(StatSnapshotDecoder::decode(
+      snapshot + "x", child_symbol_table_, [](StatName, uint64_t) {}, [](StatName, uint64_t) {}));
+  std::string bad_magic = snapshot;
+  bad_magic[0] = 'X';
+  EXPECT_FALSE(StatSnapshotDecoder::decode(
+      bad_magic, child_symbol_table_, [](StatName, uint64_t) {}, [](StatName, uint64_t) {}));
+
+  // Decoding must not leak symbols into the child's symbol table, even on failure.
+  EXPECT_EQ(0, child_symbol_table_.numSymbols());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
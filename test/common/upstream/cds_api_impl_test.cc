@@ -37,7 +37,8 @@ class CdsApiImplTest : public testing::Test {
 protected:
   void setup() {
     envoy::config::core::v3::ConfigSource cds_config;
-    cds_ = CdsApiImpl::create(cds_config, nullptr, cm_, store_, validation_visitor_);
+    cds_ = CdsApiImpl::create(cds_config, nullptr, cm_, store_, validation_visitor_,
+                              Thread::threadFactoryForTest());
     cds_->setInitializedCb([this]() -> void { initialized_.ready(); });
 
     EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
@@ -172,6 +173,33 @@ TEST_F(CdsApiImplTest, ConfigUpdateWith2ValidClusters) {
   cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "");
 }
 
+// Large updates are hashed on helper threads, but still applied in order with each cluster's own
+// hash.
+TEST_F(CdsApiImplTest, ConfigUpdateWithManyClusters) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(initialized_, ready());
+
+  std::vector<envoy::config::cluster::v3::Cluster> clusters(1000);
+  {
+    InSequence s;
+    for (size_t i = 0; i < clusters.size(); ++i) {
+      clusters[i].set_name(absl::StrCat("cluster_", i));
+      clusters[i].mutable_connect_timeout()->set_seconds(i);
+      EXPECT_CALL(cm_, addOrUpdateCluster(WithName(clusters[i].name()), "",
+                                          MessageUtil::hash(clusters[i])))
+          .WillOnce(Return(true));
+    }
+  }
+
+  const auto decoded_resources = TestUtility::decodeResources(clusters);
+  cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "");
+}
+
 TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   {
     InSequence s;
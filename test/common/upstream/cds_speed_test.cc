@@ -0,0 +1,133 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how long a CDS update with many clusters takes to apply to a real cluster manager,
+// both for new clusters and for an update that repeats the clusters unchanged, with the clusters
+// hashed on the main thread only or also on helper threads.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/router/context_impl.h"
+#include "source/common/upstream/cds_api_helper.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/server/instance.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+
+class CdsSpeedTest {
+public:
+  CdsSpeedTest(uint32_t num_clusters, bool parallel)
+      : clusters_(TestUtility::decodeResources(makeClusters(num_clusters))),
+        http_context_(factory_.stats_.symbolTable()), grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()),
+        cluster_manager_(std::make_unique<TestClusterManagerImpl>(
+            envoy::config::bootstrap::v3::Bootstrap(), factory_, factory_.stats_, factory_.tls_,
+            factory_.runtime_, factory_.local_info_, log_manager_, factory_.dispatcher_, admin_,
+            validation_context_, *factory_.api_, http_context_, grpc_context_, router_context_,
+            server_)),
+        helper_(parallel ? CdsApiHelper(*cluster_manager_, Thread::threadFactoryForTest(), "cds")
+                         : CdsApiHelper(*cluster_manager_, "cds")) {}
+
+  static std::vector<envoy::config::cluster::v3::Cluster> makeClusters(uint32_t num_clusters) {
+    std::vector<envoy::config::cluster::v3::Cluster> clusters(num_clusters);
+    for (uint32_t i = 0; i < num_clusters; ++i) {
+      envoy::config::cluster::v3::Cluster& cluster = clusters[i];
+      cluster.set_name(absl::StrCat("cluster_", i));
+      cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster.mutable_connect_timeout()->set_seconds(5);
+      auto* address = cluster.mutable_load_assignment()
+                          ->add_endpoints()
+                          ->add_lb_endpoints()
+                          ->mutable_endpoint()
+                          ->mutable_address()
+                          ->mutable_socket_address();
+      address->set_address("127.0.0.1");
+      address->set_port_value(10000 + i % 50000);
+      (*cluster.mutable_metadata()->mutable_filter_metadata())["envoy.lb"]
+          .mutable_fields()
+          ->insert({"canary", ValueUtil::boolValue(i % 10 == 0)});
+    }
+    return clusters;
+  }
+
+  void applyUpdate(const std::string& version) {
+    const std::vector<std::string> exception_msgs =
+        helper_.onConfigUpdate(clusters_.refvec_, {}, version);
+    RELEASE_ASSERT(exception_msgs.empty(), exception_msgs.front());
+  }
+
+  const Config::DecodedResourcesWrapper clusters_;
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<TestClusterManagerFactory> factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  NiceMock<Server::MockInstance> server_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+  CdsApiHelper helper_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
+
+// Adds all clusters to an empty cluster manager.
+static void addClusters(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  // if we've been instructed to skip tests, only run once no matter the argument:
+  const uint32_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  std::unique_ptr<Envoy::Upstream::CdsSpeedTest> speed_test;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // Neither tearing down the previous cluster manager nor creating the next one is timed.
+    state.PauseTiming();
+    speed_test.reset();
+    speed_test = std::make_unique<Envoy::Upstream::CdsSpeedTest>(num_clusters, state.range(1));
+    state.ResumeTiming();
+
+    speed_test->applyUpdate("1");
+  }
+}
+
+BENCHMARK(addClusters)
+    ->Args({10000, false})
+    ->Args({10000, true})
+    ->Args({50000, false})
+    ->Args({50000, true})
+    ->Unit(benchmark::kMillisecond);
+
+// Repeats an update whose clusters are all unchanged, so every cluster is hashed and skipped.
+static void unchangedClusters(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  const uint32_t num_clusters = skipExpensiveBenchmarks() ? 1 : state.range(0);
+  Envoy::Upstream::CdsSpeedTest speed_test(num_clusters, state.range(1));
+  speed_test.applyUpdate("1");
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    speed_test.applyUpdate("2");
+  }
+}
+
+BENCHMARK(unchangedClusters)
+    ->Args({10000, false})
+    ->Args({10000, true})
+    ->Args({50000, false})
+    ->Args({50000, true})
+    ->Unit(benchmark::kMillisecond);
@@ -413,6 +413,149 @@ upstream_socket_config:
   EXPECT_EQ(access_log_data_.value(), "17 3 17 3");
 }
 
+// With a batching upstream packet writer, the datagrams a session forwards in one event loop
+// iteration are sent with a single sendmmsg() call at the end of the iteration.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWrites) {
+  InSequence s;
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  checkTransferStats(11 /*rx_bytes*/, 2 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Invoke([this](const Network::RawSliceArrays& slices, int,
+                              const Network::Address::Ip*,
+                              const Network::Address::Instance& peer_address) {
+        EXPECT_EQ(2U, slices.size());
+        EXPECT_EQ("hello", absl::string_view(static_cast<const char*>(slices[0][0].mem_),
+                                             slices[0][0].len_));
+        EXPECT_EQ("hello2", absl::string_view(static_cast<const char*>(slices[1][0].mem_),
+                                              slices[1][0].len_));
+        EXPECT_EQ(*upstream_address_, peer_address);
+        return makeNoError(2);
+      }));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(11, factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_->stats_
+                    .upstream_cx_tx_bytes_total_.value());
+
+  // The next iteration's datagrams are batched again.
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello3");
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(makeNoError(1))));
+  flush_cb->invokeCallback();
+}
+
+// Datagrams which can't be sent because the upstream socket would block are dropped and counted
+// as errors, and later datagrams are still sent.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWriteErrors) {
+  InSequence s;
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(Network::IoSocketError::getIoSocketEagainInstance(),
+                             Network::IoSocketError::deleteIoError)))));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   factory_context_.cluster_manager_.thread_local_cluster_.cluster_.info_
+                       ->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello2");
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(makeNoError(1))));
+  flush_cb->invokeCallback();
+}
+
+// Queued datagrams are sent when the session is destroyed before the end of the iteration.
+TEST_F(UdpProxyFilterTest, BatchedUpstreamWritesFlushedOnSessionRemoval) {
+  InSequence s;
+
+  setup(readConfig(R"EOF(
+stat_prefix: foo
+matcher:
+  on_no_match:
+    action:
+      name: route
+      typed_config:
+        '@type': type.googleapis.com/envoy.extensions.filters.udp.udp_proxy.v3.Route
+        cluster: fake_cluster
+upstream_packet_writer_config:
+  name: envoy.udp_packet_writer.mmsg
+  typed_config:
+    '@type': type.googleapis.com/envoy.extensions.udp_packet_writer.v3.UdpMmsgBatchWriterFactory
+  )EOF"));
+
+  expectSessionCreate(upstream_address_);
+  TestSession& session = test_sessions_[0];
+  EXPECT_CALL(*session.idle_timer_, enableTimer(config_->sessionTimeout(), nullptr));
+  auto* flush_cb =
+      new NiceMock<Event::MockSchedulableCallback>(&callbacks_.udp_listener_.dispatcher_);
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+
+  EXPECT_CALL(*session.socket_->io_handle_, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(*session.socket_->io_handle_, sendmmsg(_, 0, nullptr, _))
+      .WillOnce(Return(ByMove(makeNoError(1))));
+  cluster_update_callbacks_->onClusterRemoval("fake_cluster");
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+
+  // Nothing is left to flush.
+  flush_cb->invokeCallback();
+}
+
 // Route with source IP.
 TEST_F(UdpProxyFilterTest, Router) {
   InSequence s;
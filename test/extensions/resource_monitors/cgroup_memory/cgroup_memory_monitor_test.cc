@@ -0,0 +1,205 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+
+#include "source/extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+    error_.reset();
+  }
+
+  void onFailure(const EnvoyException& error) override {
+    error_ = error;
+    pressure_.reset();
+  }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+// Populates a temporary directory with the files of a cgroup memory controller.
+class CgroupMemoryMonitorTest : public testing::Test {
+protected:
+  CgroupMemoryMonitorTest()
+      : api_(Api::createApiForTest()), cgroup_path_(TestEnvironment::temporaryPath("cgroup")) {
+    TestEnvironment::removePath(cgroup_path_);
+    TestEnvironment::createPath(cgroup_path_);
+  }
+
+  ~CgroupMemoryMonitorTest() override { TestEnvironment::removePath(cgroup_path_); }
+
+  void writeFile(const std::string& name, const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(absl::StrCat(cgroup_path_, "/", name), contents,
+                                              true);
+  }
+
+  void writeV2(const std::string& current, const std::string& max, uint64_t inactive_file) {
+    writeFile("memory.current", current);
+    writeFile("memory.max", max);
+    writeFile("memory.stat", absl::StrCat("anon 4096\nfile 8192\ninactive_file ", inactive_file,
+                                          "\nactive_file 0\n"));
+  }
+
+  void writeV1(const std::string& dir, const std::string& usage, const std::string& limit,
+               uint64_t inactive_file) {
+    writeFile(absl::StrCat(dir, "memory.usage_in_bytes"), usage);
+    writeFile(absl::StrCat(dir, "memory.limit_in_bytes"), limit);
+    writeFile(absl::StrCat(dir, "memory.stat"),
+              absl::StrCat("cache 8192\ninactive_file 1\ntotal_inactive_file ", inactive_file,
+                           "\n"));
+  }
+
+  std::unique_ptr<CgroupMemoryMonitor> createMonitor(uint64_t max_memory_bytes = 0) {
+    envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config;
+    config.set_cgroup_path(cgroup_path_);
+    config.set_max_memory_bytes(max_memory_bytes);
+    return std::make_unique<CgroupMemoryMonitor>(
+        config, std::make_unique<CgroupMemoryStatsReader>(api_->fileSystem(), cgroup_path_));
+  }
+
+  Api::ApiPtr api_;
+  const std::string cgroup_path_;
+};
+
+TEST_F(CgroupMemoryMonitorTest, ComputesV2Pressure) {
+  writeV2("1000\n", "2000\n", 200);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  ASSERT_FALSE(resource.hasError());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.4);
+
+  // Values are re-read on every update.
+  writeV2("1800\n", "2000\n", 0);
+  monitor->updateResourceUsage(resource);
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.9);
+}
+
+TEST_F(CgroupMemoryMonitorTest, ComputesV1Pressure) {
+  writeV1("", "3000\n", "4000\n", 1000);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.5);
+}
+
+TEST_F(CgroupMemoryMonitorTest, ComputesV1PressureFromMemoryController) {
+  TestEnvironment::createPath(absl::StrCat(cgroup_path_, "/memory"));
+  writeV1("memory/", "3000\n", "4000\n", 0);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.75);
+}
+
+TEST_F(CgroupMemoryMonitorTest, InactiveFileLargerThanUsage) {
+  writeV2("1000\n", "2000\n", 5000);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0);
+}
+
+TEST_F(CgroupMemoryMonitorTest, ConfiguredMaxLowerThanCgroupLimit) {
+  writeV2("1000\n", "8000\n", 0);
+  auto monitor = createMonitor(2000);
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.5);
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedV2UsesConfiguredMax) {
+  writeV2("1000\n", "max\n", 0);
+  auto monitor = createMonitor(4000);
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.25);
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedV1UsesConfiguredMax) {
+  writeV1("", "1000\n", "9223372036854771712\n", 0);
+  auto monitor = createMonitor(4000);
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.25);
+}
+
+TEST_F(CgroupMemoryMonitorTest, UnlimitedWithoutConfiguredMaxFails) {
+  writeV2("1000\n", "max\n", 0);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CgroupMemoryMonitorTest, MalformedValueFails) {
+  writeV2("garbage\n", "2000\n", 0);
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CgroupMemoryMonitorTest, MissingStat) {
+  writeFile("memory.current", "1000\n");
+  writeFile("memory.max", "2000\n");
+  auto monitor = createMonitor();
+
+  ResourcePressure resource;
+  monitor->updateResourceUsage(resource);
+  EXPECT_FALSE(resource.hasPressure());
+  EXPECT_TRUE(resource.hasError());
+
+  writeFile("memory.stat", "anon 1000\n");
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.5);
+}
+
+TEST_F(CgroupMemoryMonitorTest, NoMemoryController) {
+  EXPECT_THROW_WITH_REGEX(CgroupMemoryStatsReader(api_->fileSystem(), cgroup_path_),
+                          EnvoyException, "no cgroup memory controller found");
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
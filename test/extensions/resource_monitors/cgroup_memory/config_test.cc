@@ -0,0 +1,47 @@
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.h"
+#include "envoy/extensions/resource_monitors/cgroup_memory/v3/cgroup_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/resource_monitors/cgroup_memory/config.h"
+#include "source/server/resource_monitor_config_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/options.h"
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+TEST(CgroupMemoryMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.cgroup_memory");
+  EXPECT_NE(factory, nullptr);
+
+  const std::string cgroup_path = TestEnvironment::temporaryPath("cgroup_config");
+  TestEnvironment::createPath(cgroup_path);
+  TestEnvironment::writeStringToFileForTest(cgroup_path + "/memory.current", "0", true);
+
+  envoy::extensions::resource_monitors::cgroup_memory::v3::CgroupMemoryConfig config;
+  config.set_cgroup_path(cgroup_path);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+
+  TestEnvironment::removePath(cgroup_path);
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,41 @@
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "source/extensions/resource_monitors/cpu_pressure/config.h"
+#include "source/server/resource_monitor_config_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/options.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+namespace {
+
+TEST(CpuPressureMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.cpu_pressure");
+  EXPECT_NE(factory, nullptr);
+
+  envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig config;
+  config.set_window(
+      envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig::AVG60);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  Server::MockOptions options;
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, options, *api, ProtobufMessage::getStrictValidationVisitor());
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
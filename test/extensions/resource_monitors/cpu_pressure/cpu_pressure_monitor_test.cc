@@ -0,0 +1,121 @@
+#include "envoy/extensions/resource_monitors/cpu_pressure/v3/cpu_pressure.pb.h"
+
+#include "source/extensions/resource_monitors/cpu_pressure/cpu_pressure_monitor.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/types/optional.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CpuPressureMonitor {
+namespace {
+
+using CpuPressureConfig = envoy::extensions::resource_monitors::cpu_pressure::v3::CpuPressureConfig;
+
+class ResourcePressure : public Server::ResourceUpdateCallbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+    error_.reset();
+  }
+
+  void onFailure(const EnvoyException& error) override {
+    error_ = error;
+    pressure_.reset();
+  }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CpuPressureMonitorTest : public testing::Test {
+protected:
+  CpuPressureMonitorTest()
+      : api_(Api::createApiForTest()),
+        pressure_file_(TestEnvironment::temporaryPath("cpu.pressure")) {}
+
+  ~CpuPressureMonitorTest() override { TestEnvironment::removePath(pressure_file_); }
+
+  void writePressure(const std::string& contents) {
+    TestEnvironment::writeStringToFileForTest(pressure_file_, contents, true);
+  }
+
+  std::unique_ptr<CpuPressureMonitor> createMonitor(CpuPressureConfig::Window window) {
+    CpuPressureConfig config;
+    config.set_pressure_file(pressure_file_);
+    config.set_window(window);
+    return std::make_unique<CpuPressureMonitor>(config, api_->fileSystem());
+  }
+
+  Api::ApiPtr api_;
+  const std::string pressure_file_;
+};
+
+TEST_F(CpuPressureMonitorTest, ReportsSomeLine) {
+  writePressure("some avg10=25.00 avg60=12.50 avg300=1.00 total=123456\n"
+                "full avg10=90.00 avg60=80.00 avg300=70.00 total=654321\n");
+
+  ResourcePressure resource;
+  createMonitor(CpuPressureConfig::AVG10)->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.25);
+
+  createMonitor(CpuPressureConfig::AVG60)->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.125);
+
+  createMonitor(CpuPressureConfig::AVG300)->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.01);
+}
+
+TEST_F(CpuPressureMonitorTest, RereadsOnEveryUpdate) {
+  auto monitor = createMonitor(CpuPressureConfig::AVG10);
+  ResourcePressure resource;
+
+  writePressure("some avg10=0.00 avg60=0.00 avg300=0.00 total=0\n");
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0);
+
+  writePressure("some avg10=50.00 avg60=0.00 avg300=0.00 total=0\n");
+  monitor->updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(resource.pressure(), 0.5);
+}
+
+TEST_F(CpuPressureMonitorTest, MissingFileFails) {
+  ResourcePressure resource;
+  createMonitor(CpuPressureConfig::AVG10)->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CpuPressureMonitorTest, MissingSomeLineFails) {
+  writePressure("full avg10=90.00 avg60=80.00 avg300=70.00 total=654321\n");
+  ResourcePressure resource;
+  createMonitor(CpuPressureConfig::AVG10)->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasError());
+}
+
+TEST_F(CpuPressureMonitorTest, MalformedValueFails) {
+  writePressure("some avg10=abc avg60=0.00 avg300=0.00 total=0\n");
+  ResourcePressure resource;
+  createMonitor(CpuPressureConfig::AVG10)->updateResourceUsage(resource);
+  EXPECT_TRUE(resource.hasError());
+}
+
+} // namespace
+} // namespace CpuPressureMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
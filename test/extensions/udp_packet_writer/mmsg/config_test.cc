@@ -0,0 +1,50 @@
+#include "envoy/extensions/udp_packet_writer/v3/udp_mmsg_batch_writer_factory.pb.h"
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/extensions/udp_packet_writer/mmsg/config.h"
+
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+TEST(FactoryTest, Name) {
+  UdpMmsgBatchWriterFactoryFactory factory;
+  EXPECT_EQ(factory.name(), "envoy.udp_packet_writer.mmsg");
+}
+
+TEST(FactoryTest, CreateEmptyConfigProto) {
+  UdpMmsgBatchWriterFactoryFactory factory;
+  EXPECT_TRUE(factory.createEmptyConfigProto() != nullptr);
+}
+
+TEST(FactoryTest, CreateUdpPacketWriterFactory) {
+  UdpMmsgBatchWriterFactoryFactory factory;
+  envoy::extensions::udp_packet_writer::v3::UdpMmsgBatchWriterFactory writer_config;
+  writer_config.mutable_max_batch_size()->set_value(16);
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.mutable_typed_config()->PackFrom(writer_config);
+  UdpPacketWriterFactoryPtr writer_factory = factory.createUdpPacketWriterFactory(config);
+  ASSERT_TRUE(writer_factory != nullptr);
+
+  testing::NiceMock<MockIoHandle> io_handle;
+  Stats::IsolatedStoreImpl scope;
+  EXPECT_TRUE(writer_factory->createUdpPacketWriter(io_handle, scope)->isBatchMode());
+}
+
+TEST(FactoryTest, RejectsZeroMaxBatchSize) {
+  UdpMmsgBatchWriterFactoryFactory factory;
+  envoy::extensions::udp_packet_writer::v3::UdpMmsgBatchWriterFactory writer_config;
+  writer_config.mutable_max_batch_size()->set_value(0);
+  envoy::config::core::v3::TypedExtensionConfig config;
+  config.mutable_typed_config()->PackFrom(writer_config);
+  EXPECT_THROW(factory.createUdpPacketWriterFactory(config), ProtoValidationException);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
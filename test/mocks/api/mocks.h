@@ -90,6 +90,8 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
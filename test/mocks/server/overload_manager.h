@@ -14,6 +14,7 @@ class MockThreadLocalOverloadState : public ThreadLocalOverloadState {
 public:
   MockThreadLocalOverloadState();
   MOCK_METHOD(const OverloadActionState&, getState, (const std::string&), (override));
+  MOCK_METHOD(void, syncActionStates, (), (override));
   MOCK_METHOD(bool, tryAllocateResource, (OverloadProactiveResourceName, int64_t));
   MOCK_METHOD(bool, tryDeallocateResource, (OverloadProactiveResourceName, int64_t));
   MOCK_METHOD(bool, isResourceMonitorEnabled, (OverloadProactiveResourceName));
@@ -98,6 +98,8 @@ public:
               (const));
   MOCK_METHOD(float, perUpstreamPreconnectRatio, (), (const));
   MOCK_METHOD(float, peekaheadRatio, (), (const));
+  MOCK_METHOD(const absl::optional<std::chrono::milliseconds>, adaptivePreconnectTargetQueueWait,
+              (), (const));
   MOCK_METHOD(uint32_t, perConnectionBufferLimitBytes, (), (const));
   MOCK_METHOD(uint64_t, features, (), (const));
   MOCK_METHOD(const Http::Http1Settings&, http1Settings, (), (const));
@@ -24,6 +24,12 @@ MockClusterManager::MockClusterManager()
   ON_CALL(*this, grpcAsyncClientManager()).WillByDefault(ReturnRef(async_client_manager_));
   ON_CALL(*this, localClusterName()).WillByDefault((ReturnRef(local_cluster_name_)));
   ON_CALL(*this, subscriptionFactory()).WillByDefault(ReturnRef(subscription_factory_));
+  // Tests set expectations on the overload without a precomputed hash.
+  ON_CALL(*this, addOrUpdateCluster(_, _, _))
+      .WillByDefault(Invoke([this](const envoy::config::cluster::v3::Cluster& cluster,
+                                   const std::string& version_info, uint64_t) -> bool {
+        return addOrUpdateCluster(cluster, version_info);
+      }));
   ON_CALL(*this, allocateOdCdsApi(_, _, _))
       .WillByDefault(Invoke([](const envoy::config::core::v3::ConfigSource&,
                                OptRef<xds::core::v3::ResourceLocator>,
@@ -0,0 +1,171 @@
+// Compares the two ways a hot restart child can receive its parent's stats: the protobuf maps
+// keyed by full stat name, and the snapshot written by Stats::StatSnapshotBuilder that is
+// normally handed over in shared memory. Each iteration merges into a fresh child store, so the
+// timings cover decoding plus creating every stat, which is what the child pays on its first
+// merge. The "transfer_bytes" counter reports the size of what crosses between the processes.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/stats/isolated_store_impl.h"
+#include "source/common/stats/stat_merger.h"
+#include "source/common/stats/stat_snapshot.h"
+#include "source/common/stats/symbol_table.h"
+#include "source/server/hot_restart.pb.h"
+
+#include "test/benchmark/main.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+
+class HotRestartStatsMergeSpeedTest {
+public:
+  // Builds num_stats counters and num_stats gauges in the parent, named like per-cluster stats.
+  // One service in ten has a dynamic name component.
+  explicit HotRestartStatsMergeSpeedTest(uint64_t num_stats) {
+    Stats::StatNamePool symbolic_pool(parent_symbol_table_);
+    Stats::StatNameDynamicPool dynamic_pool(parent_symbol_table_);
+    Stats::StatSnapshotBuilder snapshot(parent_symbol_table_);
+    envoy::HotRestartMessage::Reply::Stats stats_proto;
+
+    const Stats::StatName cluster = symbolic_pool.add("cluster");
+    std::vector<Stats::StatName> counter_leaves;
+    std::vector<Stats::StatName> gauge_leaves;
+    for (uint64_t leaf_idx = 0; leaf_idx < 100; ++leaf_idx) {
+      counter_leaves.push_back(symbolic_pool.add(absl::StrCat("upstream_rq_", leaf_idx)));
+      gauge_leaves.push_back(symbolic_pool.add(absl::StrCat("membership_", leaf_idx)));
+    }
+
+    Stats::StatName service_name;
+    for (uint64_t idx = 0; idx < num_stats; ++idx) {
+      const uint64_t service_idx = idx / 100;
+      if (idx % 100 == 0) {
+        const std::string service = absl::StrCat("service_", service_idx);
+        service_name =
+            service_idx % 10 == 0 ? dynamic_pool.add(service) : symbolic_pool.add(service);
+      }
+      const Stats::StatName counter_leaf = counter_leaves[idx % 100];
+      const Stats::StatName gauge_leaf = gauge_leaves[idx % 100];
+
+      Stats::SymbolTable::StoragePtr counter =
+          parent_symbol_table_.join({cluster, service_name, counter_leaf});
+      Stats::SymbolTable::StoragePtr gauge =
+          parent_symbol_table_.join({cluster, service_name, gauge_leaf});
+      addToProto(Stats::StatName(counter.get()), idx, *stats_proto.mutable_counter_deltas(),
+                 stats_proto);
+      addToProto(Stats::StatName(gauge.get()), idx, *stats_proto.mutable_gauges(), stats_proto);
+      snapshot.addCounter(Stats::StatName(counter.get()), idx);
+      snapshot.addGauge(Stats::StatName(gauge.get()), idx);
+    }
+
+    serialized_proto_ = stats_proto.SerializeAsString();
+    snapshot_ = snapshot.serialize();
+  }
+
+  void mergeProtoMaps(::benchmark::State& state) {
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      state.PauseTiming();
+      auto child = std::make_unique<Child>();
+      state.ResumeTiming();
+
+      envoy::HotRestartMessage::Reply::Stats stats_proto;
+      RELEASE_ASSERT(stats_proto.ParseFromString(serialized_proto_), "");
+      Stats::StatMerger::DynamicsMap dynamics;
+      for (const auto& iter : stats_proto.dynamics()) {
+        Stats::DynamicSpans& spans = dynamics[iter.first];
+        for (const auto& span_proto : iter.second.spans()) {
+          spans.push_back(Stats::DynamicSpan(span_proto.first(), span_proto.last()));
+        }
+      }
+      child->merger_.mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
+
+      state.PauseTiming();
+      child.reset();
+      state.ResumeTiming();
+    }
+    state.counters["transfer_bytes"] = serialized_proto_.size();
+  }
+
+  void mergeSnapshot(::benchmark::State& state) {
+    for (auto _ : state) {
+      UNREFERENCED_PARAMETER(_);
+      state.PauseTiming();
+      auto child = std::make_unique<Child>();
+      state.ResumeTiming();
+
+      RELEASE_ASSERT(child->merger_.mergeSnapshot(snapshot_), "");
+
+      state.PauseTiming();
+      child.reset();
+      state.ResumeTiming();
+    }
+    state.counters["transfer_bytes"] = snapshot_.size();
+  }
+
+private:
+  struct Child {
+    Stats::SymbolTableImpl symbol_table_;
+    Stats::IsolatedStoreImpl store_{symbol_table_};
+    Stats::StatMerger merger_{store_};
+  };
+
+  // Mirrors HotRestartingParent::Internal::exportStatsToChild().
+  void addToProto(Stats::StatName stat_name, uint64_t value,
+                  Protobuf::Map<std::string, uint64_t>& map,
+                  envoy::HotRestartMessage::Reply::Stats& stats_proto) {
+    const std::string name = parent_symbol_table_.toString(stat_name);
+    map[name] = value;
+    const Stats::DynamicSpans spans = parent_symbol_table_.getDynamicSpans(stat_name);
+    if (!spans.empty()) {
+      envoy::HotRestartMessage::Reply::RepeatedSpan& spans_proto =
+          (*stats_proto.mutable_dynamics())[name];
+      for (const Stats::DynamicSpan& span : spans) {
+        envoy::HotRestartMessage::Reply::Span* span_proto = spans_proto.add_spans();
+        span_proto->set_first(span.first);
+        span_proto->set_last(span.second);
+      }
+    }
+  }
+
+  Stats::SymbolTableImpl parent_symbol_table_;
+  std::string serialized_proto_;
+  std::string snapshot_;
+};
+
+static void bmMergeProtoMaps(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  HotRestartStatsMergeSpeedTest speed_test(state.range(0));
+  speed_test.mergeProtoMaps(state);
+}
+
+static void bmMergeSnapshot(::benchmark::State& state) {
+  // Skip expensive benchmarks for unit tests.
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  HotRestartStatsMergeSpeedTest speed_test(state.range(0));
+  speed_test.mergeSnapshot(state);
+}
+
+BENCHMARK(bmMergeProtoMaps)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+BENCHMARK(bmMergeSnapshot)
+    ->Unit(::benchmark::kMillisecond)
+    ->RangeMultiplier(10)
+    ->Range(1000, 1000000);
+
+} // namespace Envoy
@@ -219,6 +219,53 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportStatsSnapshotToChild) {
+  MockListenerManager listener_manager;
+  Stats::SymbolTableImpl parent_symbol_table;
+  Stats::TestUtil::TestStore parent_store(parent_symbol_table);
+
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(7));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+
+  HotRestartMessage::Reply::Stats stats_proto;
+  {
+    Stats::StatNameDynamicPool dynamic(parent_store.symbolTable());
+    parent_store.counter("c1").inc();
+    parent_store.counterFromStatName(dynamic.add("c2")).add(2);
+    parent_store.counter("unused_counter");
+    parent_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+    parent_store.gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate).set(42);
+    hot_restarting_parent_.exportStatsSnapshotToChild(&stats_proto);
+  }
+
+  // The stats travel in the snapshot, normally through shared memory, instead of the maps.
+  EXPECT_TRUE(stats_proto.counter_deltas().empty());
+  EXPECT_TRUE(stats_proto.gauges().empty());
+  EXPECT_TRUE(stats_proto.dynamics().empty());
+  EXPECT_TRUE(stats_proto.snapshot_size() > 0 || !stats_proto.inline_snapshot().empty());
+  EXPECT_EQ(7, stats_proto.num_connections());
+
+  {
+    Stats::SymbolTableImpl child_symbol_table;
+    Stats::TestUtil::TestStore child_store(child_symbol_table);
+    Stats::StatNameDynamicPool dynamic(child_store.symbolTable());
+    Stats::Counter& c1 = child_store.counter("c1");
+    Stats::Counter& c2 = child_store.counterFromStatName(dynamic.add("c2"));
+    Stats::Gauge& g1 = child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+    Stats::Gauge& g2 =
+        child_store.gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate);
+
+    HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+    hot_restarting_child.mergeParentStats(child_store, stats_proto);
+    EXPECT_EQ(1, c1.value());
+    EXPECT_EQ(2, c2.value());
+    EXPECT_EQ(123, g1.value());
+    EXPECT_EQ(42, g2.value());
+    EXPECT_FALSE(child_store.findCounterByString("unused_counter").has_value());
+  }
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
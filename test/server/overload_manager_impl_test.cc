@@ -804,6 +804,86 @@ TEST_F(OverloadManagerImplTest, Shutdown) {
   manager->stop();
 }
 
+constexpr char kSharedActionStatesConfig[] = R"YAML(
+  refresh_interval:
+    seconds: 1
+  share_action_states: true
+  resource_monitors:
+    - name: envoy.resource_monitors.fake_resource1
+  actions:
+    - name: envoy.overload_actions.dummy_action
+      triggers:
+        - name: envoy.resource_monitors.fake_resource1
+          threshold:
+            value: 0.9
+)YAML";
+
+// Simulates overload while the worker is too busy to run the thread-local updates posted to it,
+// and checks how many refresh intervals and worker posts it takes for a new request on the worker
+// to observe the action.
+TEST_F(OverloadManagerImplTest, SharedActionStatesReactionTime) {
+  setDispatcherExpectation();
+  std::vector<Event::PostCb> pending_worker_updates;
+  EXPECT_CALL(thread_local_, runOnAllThreads(_))
+      .WillRepeatedly(
+          Invoke([&](Event::PostCb cb) { pending_worker_updates.push_back(std::move(cb)); }));
+
+  auto manager(createOverloadManager(kSharedActionStatesConfig));
+  manager->start();
+  ThreadLocalOverloadState& overload_state = manager->getThreadLocalOverloadState();
+  const OverloadActionState& action_state =
+      overload_state.getState("envoy.overload_actions.dummy_action");
+
+  // The action becomes visible to the worker within one refresh interval, without running any
+  // of the posted updates.
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  EXPECT_EQ(1, pending_worker_updates.size());
+  EXPECT_FALSE(action_state.isSaturated());
+  overload_state.syncActionStates();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  factory1_.monitor_->setPressure(0.5);
+  timer_cb_();
+  EXPECT_EQ(2, pending_worker_updates.size());
+  overload_state.syncActionStates();
+  EXPECT_FALSE(action_state.isSaturated());
+
+  // Late updates carry stale states and must not override the newer shared state.
+  for (auto& cb : pending_worker_updates) {
+    cb();
+  }
+  EXPECT_FALSE(action_state.isSaturated());
+
+  manager->stop();
+}
+
+TEST_F(OverloadManagerImplTest, UnsharedActionStatesWaitForWorkerUpdate) {
+  setDispatcherExpectation();
+  std::vector<Event::PostCb> pending_worker_updates;
+  EXPECT_CALL(thread_local_, runOnAllThreads(_))
+      .WillRepeatedly(
+          Invoke([&](Event::PostCb cb) { pending_worker_updates.push_back(std::move(cb)); }));
+
+  auto manager(createOverloadManager(kRegularStateConfig));
+  manager->start();
+  ThreadLocalOverloadState& overload_state = manager->getThreadLocalOverloadState();
+  const OverloadActionState& action_state =
+      overload_state.getState("envoy.overload_actions.dummy_action");
+
+  // Without shared states, the worker only observes the action once the posted update runs.
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  overload_state.syncActionStates();
+  EXPECT_FALSE(action_state.isSaturated());
+
+  ASSERT_EQ(1, pending_worker_updates.size());
+  pending_worker_updates[0]();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  manager->stop();
+}
+
 TEST_F(OverloadManagerImplTest, MissingConfigTriggerType) {
   constexpr char missingTriggerTypeConfig[] = R"YAML(
   actions: